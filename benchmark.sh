@@ -0,0 +1,39 @@
+#!/bin/sh
+#
+# File: benchmark.sh
+# -------------------------
+# Generates a synthetic honeycomb and dictionary with generateInput
+# and runs every search mode of hexagonalSearch on them, printing the
+# --bench line of each run prefixed with the input parameters, one
+# line of key=value pairs per run.
+# Parameters are taken from the environment (see the defaults below),
+# e.g. "LAYERS=500 WORDS=400000 LETTERS=skewed ./benchmark.sh".
+#
+
+LAYERS=${LAYERS:-100}
+WORDS=${WORDS:-100000}
+MIN_LENGTH=${MIN_LENGTH:-3}
+MAX_LENGTH=${MAX_LENGTH:-10}
+LETTERS=${LETTERS:-english}
+HITS=${HITS:-0.1}
+SEED=${SEED:-1}
+MODES=${MODES:-"word iterative anchor lockstep trie implicit"}
+CORES=$(nproc 2>/dev/null || echo 1)
+THREADS=${THREADS:-$(if [ "$CORES" -gt 1 ]; then echo "1 $CORES"; else echo 1; fi)}
+DATA=${DATA:-benchmark_data}
+
+set -e
+mkdir -p "$DATA"
+HONEYCOMB="$DATA/honeycomb_${LAYERS}_${LETTERS}_${SEED}.txt"
+DICTIONARY="$DATA/dictionary_${WORDS}_${MIN_LENGTH}_${MAX_LENGTH}_${LETTERS}_${SEED}.txt"
+
+./generateInput honeycomb --layers "$LAYERS" --letters "$LETTERS" --seed "$SEED" > "$HONEYCOMB"
+./generateInput dictionary --words "$WORDS" --min-length "$MIN_LENGTH" --max-length "$MAX_LENGTH" \
+	--letters "$LETTERS" --seed "$SEED" --board "$HONEYCOMB" --hits "$HITS" > "$DICTIONARY"
+
+for mode in $MODES; do
+	for threads in $THREADS; do
+		result=$(./hexagonalSearch --bench --mode "$mode" --threads "$threads" "$HONEYCOMB" "$DICTIONARY" 2>&1 >/dev/null)
+		echo "layers=$LAYERS letters=$LETTERS dictionary_words=$WORDS min_length=$MIN_LENGTH max_length=$MAX_LENGTH hits=$HITS seed=$SEED $result"
+	done
+done
@@ -0,0 +1,72 @@
+/*
+ * File: boundedQueue.h
+ * -------------------------
+ * Blocking queue of bounded capacity passing work between
+ * the threads of a staged pipeline: a stage waits on it for
+ * the next item, and the stage before it waits for room, so
+ * a fast stage cannot run arbitrarily far ahead of a slow one.
+ */
+
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+/* Packages */
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+/*
+ * Struct holding a first-in first-out queue of at most a given
+ * number of items, shared by any number of producer and consumer
+ * threads. Once closed, no more items are taken, and the consumers
+ * are told so after the items left have been removed.
+ */
+template<typename T>
+struct boundedQueue
+{
+	/* Data */
+	size_t capacity;
+	std::deque<T> items;
+	bool closed = false;
+	std::mutex mutex;
+	std::condition_variable notEmpty;
+	std::condition_variable notFull;
+
+	/* Functions */
+	boundedQueue(const size_t maxItems) : capacity(maxItems) {}
+	boundedQueue(const boundedQueue &) = delete;
+	boundedQueue & operator=(const boundedQueue &) = delete;
+
+	//waits for room and appends an item, returns false (dropping it) if the queue is closed
+	bool push(T item) {
+		std::unique_lock<std::mutex> lock(mutex);
+		notFull.wait(lock, [&]() { return closed || items.size() < capacity; });
+		if (closed) return false;
+
+		items.push_back(std::move(item));
+		notEmpty.notify_one();
+		return true;
+	}
+
+	//waits for an item and moves the oldest into item, returns false once the queue is closed and empty
+	bool pop(T &item) {
+		std::unique_lock<std::mutex> lock(mutex);
+		notEmpty.wait(lock, [&]() { return closed || !items.empty(); });
+		if (items.empty()) return false;
+
+		item = std::move(items.front());
+		items.pop_front();
+		notFull.notify_one();
+		return true;
+	}
+
+	//wakes every waiting thread, the producers to give up and the consumers to drain the queue
+	void close() {
+		std::lock_guard<std::mutex> lock(mutex);
+		closed = true;
+		notEmpty.notify_all();
+		notFull.notify_all();
+	}
+};
+
+#endif
@@ -0,0 +1,66 @@
+/*
+ * File: bufferedWriter.h
+ * -------------------------
+ * Output buffer for writing many short lines, such as the
+ * words found, without flushing the stream after every line.
+ */
+
+#ifndef BUFFERED_WRITER_H
+#define BUFFERED_WRITER_H
+
+/* Packages */
+#include <stdio.h>
+#include <string.h>
+#include <string_view>
+#include <vector>
+
+/*
+ * Struct collecting output in a fixed-size buffer, writing it to
+ * a file only when the buffer is full or when flushed explicitly.
+ * Whatever is left is written when the writer is destroyed.
+ */
+struct bufferedWriter
+{
+	/* Data */
+	FILE *file;
+	std::vector<char> buffer;
+	size_t used = 0;
+
+	/* Functions */
+	bufferedWriter(FILE *output, const size_t capacity = 1 << 16) : file(output), buffer(capacity) {}
+	bufferedWriter(const bufferedWriter &) = delete;
+	bufferedWriter & operator=(const bufferedWriter &) = delete;
+	~bufferedWriter() {
+		flush();
+	}
+
+	void write(const std::string_view text) {
+		if (used + text.length() > buffer.size()) {
+			writeBuffer();
+			if (text.length() > buffer.size()) { //too long to buffer
+				fwrite(text.data(), 1, text.length(), file);
+				return;
+			}
+		}
+		memcpy(buffer.data() + used, text.data(), text.length());
+		used += text.length();
+	}
+
+	void writeLine(const std::string_view line) {
+		write(line);
+		write("\n");
+	}
+
+	//writes out the buffer and flushes the file, e.g. at the end of a reply
+	void flush() {
+		writeBuffer();
+		fflush(file);
+	}
+
+	void writeBuffer() {
+		if (used > 0) fwrite(buffer.data(), 1, used, file);
+		used = 0;
+	}
+};
+
+#endif
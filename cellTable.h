@@ -0,0 +1,475 @@
+/*
+ * File: cellTable.h
+ * -------------------------
+ * Flat representation of a honeycomb tessellation of
+ * hexagonal cells. Each cell is identified by a single
+ * linear id, counting layer by layer from the central
+ * cell outwards, and its letter and neighbor ids are
+ * kept in contiguous arrays indexed by that id.
+ * Missing neighbors are marked with the NO_CELL sentinel.
+ */
+
+#ifndef CELL_TABLE_H
+#define CELL_TABLE_H
+
+/* Packages */
+#include <algorithm>
+#include <math.h>
+#include <memory>
+#include <stdint.h>
+#include <string_view>
+#include <vector>
+
+/* Macros */
+#define SIDES 6
+#define ALPHABET 26
+#define NO_CELL UINT32_MAX
+
+/*
+ * Function name: getBucket(value)
+ * Returns the position of a given capital letter amongst all
+ * capital letters.
+ */
+const inline size_t getBucket(const char value) {
+	return value - 'A';
+}
+
+/*
+ * Function name: isCorner(layerN, charN)
+ * Returns whether the node at the given coordinates is a corner node
+ */
+const inline bool isCorner(const size_t layerN, const size_t charN) {
+	if (layerN == 0) return true;
+	return (charN % layerN == 0);
+}
+
+/*
+ * Function name: getLayerStart(layerN)
+ * Returns the id of the first cell of a given layer, as layer L
+ * (L > 0) of a honeycomb holds exactly SIDES * L cells
+ */
+const inline size_t getLayerStart(const size_t layerN) {
+	if (layerN == 0) return 0;
+	return 1 + SIDES * layerN * (layerN - 1) / 2;
+}
+
+/*
+ * Function name: getLayerSize(layerN)
+ * Returns the number of cells in a given layer of a honeycomb
+ */
+const inline size_t getLayerSize(const size_t layerN) {
+	if (layerN == 0) return 1;
+	return SIDES * layerN;
+}
+
+/*
+ * Function name: isHoneycomb(layers)
+ * Returns whether every given layer has the number of cells
+ * its position in a honeycomb requires
+ */
+inline bool isHoneycomb(const std::vector<std::string_view> &layers) {
+	for (size_t layerN = 0; layerN < layers.size(); layerN++) {
+		if (layers[layerN].length() != getLayerSize(layerN)) return false;
+	}
+	return true;
+}
+
+/*
+ * Struct defining the position of a cell in a honeycomb:
+ * its layer and its index within the layer.
+ */
+struct cellCoordinates
+{
+	uint32_t layerN;
+	uint32_t charN;
+};
+
+/*
+ * Function name: getCellCoordinates(cell)
+ * Returns the coordinates of the cell with a given linear id,
+ * inverting getLayerStart() in closed form
+ */
+inline cellCoordinates getCellCoordinates(const size_t cell) {
+	if (cell == 0) return { 0, 0 };
+
+	//largest layer L with 1 + 3L(L - 1) <= cell, corrected for rounding
+	size_t layerN = (3 + (size_t)sqrt(12.0 * cell - 3)) / 6;
+	while (getLayerStart(layerN) > cell) layerN--;
+	while (getLayerStart(layerN + 1) <= cell) layerN++;
+
+	return { (uint32_t)layerN, (uint32_t)(cell - getLayerStart(layerN)) };
+}
+
+/*
+ * Function name: getNeighborCoordinates(layerCount, cell, adjacentList)
+ * Sets the coordinates of the SIDES neighbors of a cell of a honeycomb
+ * with a given number of layers, in the neighbor order of cellTable.
+ * Missing neighbors get a layer of NO_CELL.
+ * Values for neighbors' coordinates follow from mathematical derivation
+ * Specific to SIDES = 6
+ */
+inline void getNeighborCoordinates(const size_t layerCount, const cellCoordinates cell, cellCoordinates adjacentList[SIDES]) {
+	const uint32_t layerN = cell.layerN;
+	const uint32_t charN = cell.charN;
+	const uint32_t charCount = getLayerSize(layerN);
+
+	for (size_t neighborN = 0; neighborN < SIDES; neighborN++) {
+		adjacentList[neighborN] = { NO_CELL, 0 };
+	}
+
+	if (layerN > 0) {
+		//inside neighbor (if corner) or inside right neighbor (otherwise)
+		if (charN < charCount - 1) adjacentList[0] = { layerN - 1, (layerN - 1) * (charN / layerN) + (charN % layerN) };
+		else adjacentList[0] = { layerN - 1, 0 };
+
+		//inside left neighbor (only exists if not corner)
+		if (!isCorner(layerN, charN)) {
+			adjacentList[5] = { layerN - 1, (layerN - 1) * (charN / layerN) + (charN % layerN) - 1 };
+		}
+
+		//left neighbor
+		if (charN > 0) adjacentList[1] = { layerN, charN - 1 };
+		else adjacentList[1] = { layerN, charCount - 1 };
+
+		//right neighbor
+		if (charN < charCount - 1) adjacentList[2] = { layerN, charN + 1 };
+		else adjacentList[2] = { layerN, 0 };
+
+		if (layerN < layerCount - 1) {
+			//outside left neighbor (only exists if corner)
+			if (isCorner(layerN, charN)) {
+				if (charN > 0) adjacentList[5] = { layerN + 1, (layerN + 1) * (charN / layerN) - 1 };
+				else adjacentList[5] = { layerN + 1, charCount + SIDES - 1 }; //last of next layer
+			}
+
+			//outside middle neighbor (if corner) or outside left (otherwise)
+			adjacentList[3] = { layerN + 1, (layerN + 1) * (charN / layerN) + (charN % layerN) };
+
+			//outside right neighbor
+			adjacentList[4] = { layerN + 1, (layerN + 1) * (charN / layerN) + (charN % layerN) + 1 };
+		}
+	} else if (layerCount > 1) {
+		//manually set for central cell
+		for (uint32_t neighborN = 0; neighborN < SIDES; neighborN++) {
+			adjacentList[neighborN] = { 1, neighborN };
+		}
+	}
+}
+
+/*
+ * Function name: getCellNeighbors(layerCount, cell, adjacentList)
+ * Sets the ids of the SIDES neighbors of the cell with a given id in a
+ * honeycomb with a given number of layers, computed on the fly instead
+ * of read from a cell table. Missing neighbors are set to NO_CELL.
+ */
+inline void getCellNeighbors(const size_t layerCount, const uint32_t cell, uint32_t adjacentList[SIDES]) {
+	cellCoordinates neighbors[SIDES];
+	getNeighborCoordinates(layerCount, getCellCoordinates(cell), neighbors);
+
+	for (size_t neighborN = 0; neighborN < SIDES; neighborN++) {
+		if (neighbors[neighborN].layerN == NO_CELL) adjacentList[neighborN] = NO_CELL;
+		else adjacentList[neighborN] = getLayerStart(neighbors[neighborN].layerN) + neighbors[neighborN].charN;
+	}
+}
+
+/*
+ * Struct defining a polygonal structure of characters
+ * as a struct of arrays. For every cell id it holds the
+ * letter and the ids of the adjacent cells. The ids of the
+ * cells holding each letter are kept contiguously, bucket by
+ * bucket, in ascending order of id; bucketStart gives the
+ * range of each bucket, so the bucket sizes are the letter
+ * histogram of the board. adjacentLetters is the adjacency
+ * bigram bitmap: bit b of entry a is set if a cell with letter
+ * a has a neighbor with letter b. neighborLetters packs the
+ * letters of a cell's neighbors into one word, a zero byte for
+ * a missing neighbor, so the neighbors holding a letter are found
+ * with a single SWAR comparison (see getMatchingNeighbors()).
+ * The table is not modified by searches, which
+ * keep their own visitedSet so that several may run at once.
+ * All of the arrays are carved out of one arena sized from
+ * the cell count, so building a table is a single allocation
+ * (none at all when an arena large enough is reused) and the
+ * cells are laid out in layer order.
+ * The missing neighbors, if any exist, are not
+ * necessarily at the end of a cell's neighbor slots.
+ * For hexagonal polygons, the adjacents should come
+ * in the predetermined order of lowest layer index to
+ * greatest and lowest sublayer index to greatest; other
+ * topologies set their own (see gridTopology.h).
+ */
+template<size_t adjacentN = SIDES>
+struct cellTable
+{
+	/* Data */
+	size_t layerCount = 0;
+	size_t cellCount = 0;
+	uint64_t *neighborLetters = NULL; //letters of the adjacentN neighbors per cell, one byte per slot
+	uint32_t *neighbors = NULL; //adjacentN neighbor ids per cell
+	uint32_t *bucketCells = NULL; //ids of the cells holding each letter
+	char *letters = NULL; //letter of each cell
+	size_t bucketStart[ALPHABET + 1]; //position of the first cell of each bucket, followed by the end
+	uint32_t adjacentLetters[ALPHABET]; //per letter, bitmask of the letters found next to it
+
+	std::unique_ptr<uint64_t[]> arena; //single block holding all of the arrays above
+	size_t arenaCapacity = 0; //size of the arena in words
+
+	/* Functions */
+	//lays out the arrays for a given number of layers (or rows) and cells, only allocating if the arena is too small
+	void allocate(const size_t layers, const size_t cells) {
+		static_assert(adjacentN <= 8, "neighbor letters are packed into one word");
+		layerCount = layers;
+		cellCount = cells;
+
+		size_t words = cellCount + (cellCount * adjacentN + cellCount + 1) / 2 + (cellCount + 7) / 8;
+		if (words > arenaCapacity) {
+			arena.reset(new uint64_t[words]);
+			arenaCapacity = words;
+		}
+
+		neighborLetters = arena.get();
+		neighbors = (uint32_t *)(neighborLetters + cellCount);
+		bucketCells = neighbors + cellCount * adjacentN;
+		letters = (char *)(bucketCells + cellCount);
+	}
+
+	size_t getCellCount() const {
+		return cellCount;
+	}
+
+	size_t getLayerCount() const {
+		return layerCount;
+	}
+
+	//honeycombs only
+	uint32_t getCell(const size_t layerN, const size_t charN) const {
+		return getLayerStart(layerN) + charN;
+	}
+
+	uint32_t getNeighbor(const uint32_t cell, const size_t neighborN) const {
+		return neighbors[cell * adjacentN + neighborN];
+	}
+
+	//returns a mask with the high bit set in the byte of every neighbor slot of a cell holding a given letter
+	uint64_t getMatchingNeighbors(const uint32_t cell, const char value) const {
+		const uint64_t low = 0x7F7F7F7F7F7F7F7Full;
+		uint64_t difference = neighborLetters[cell] ^ (0x0101010101010101ull * (unsigned char)value); //zero bytes match
+		return ~(((difference & low) + low) | difference | low);
+	}
+
+	size_t getBucketSize(const size_t bucket) const {
+		return bucketStart[bucket + 1] - bucketStart[bucket];
+	}
+};
+
+/*
+ * Struct defining the set of cells visited by a search as a
+ * bitset over the cell ids. Kept apart from the cell table so
+ * that every search thread owns its own.
+ */
+struct visitedSet
+{
+	/* Data */
+	std::vector<uint64_t> bits;
+
+	/* Functions */
+	visitedSet(const size_t cellCount = 0) : bits((cellCount + 63) / 64, 0) {}
+
+	bool test(const uint32_t cell) const {
+		return (bits[cell >> 6] >> (cell & 63)) & 1;
+	}
+
+	void set(const uint32_t cell) {
+		bits[cell >> 6] |= (uint64_t)1 << (cell & 63);
+	}
+
+	void reset(const uint32_t cell) {
+		bits[cell >> 6] &= ~((uint64_t)1 << (cell & 63));
+	}
+};
+
+/*
+ * Function name: populateCellTable(layers, table)
+ * Fills a cell table using a given polygon of characters.
+ * Copies the letters layer by layer, from lowest to greatest,
+ * then places the cells in their letter buckets with one
+ * counting sort pass. Cells whose value is not a capital letter
+ * are left out of the buckets since no word can contain them.
+ * The layers must form a board of the topology of the table
+ * (see gridTopology.h), such as a honeycomb (see isHoneycomb()).
+ * WARNING: does not set neighbors!
+ */
+template<size_t adjacentN>
+inline void populateCellTable(const std::vector<std::string_view> &layers, cellTable<adjacentN> &table) {
+	size_t cellCount = 0;
+	for (std::string_view layer : layers) cellCount += layer.length();
+	table.allocate(layers.size(), cellCount);
+
+	size_t layerStart = 0;
+	for (std::string_view layer : layers) {
+		layer.copy(table.letters + layerStart, layer.length());
+		layerStart += layer.length();
+	}
+	std::fill(table.neighbors, table.neighbors + cellCount * adjacentN, NO_CELL);
+
+	//count the cells per letter, then turn the counts into bucket ends
+	size_t bucketEnd[ALPHABET] = { 0 };
+	for (size_t cell = 0; cell < cellCount; cell++) {
+		size_t bucket = getBucket(table.letters[cell]);
+		if (bucket < ALPHABET) bucketEnd[bucket]++;
+	}
+
+	size_t position = 0;
+	for (size_t bucket = 0; bucket < ALPHABET; bucket++) {
+		table.bucketStart[bucket] = position;
+		position += bucketEnd[bucket];
+		bucketEnd[bucket] = table.bucketStart[bucket]; //next free position of the bucket
+	}
+	table.bucketStart[ALPHABET] = position;
+
+	for (size_t cell = 0; cell < cellCount; cell++) {
+		size_t bucket = getBucket(table.letters[cell]);
+		if (bucket < ALPHABET) table.bucketCells[bucketEnd[bucket]++] = cell;
+	}
+}
+
+/*
+ * Function name: setNeighbors(table)
+ * Sets the neighbor ids of all cells in the cell table
+ * from getNeighborCoordinates()
+ */
+inline void setNeighbors(cellTable<SIDES> &table) {
+	size_t layerCount = table.getLayerCount();
+	for (size_t layerN = 0; layerN < layerCount; layerN++) {
+		size_t charCount = getLayerSize(layerN);
+		for (size_t charN = 0; charN < charCount; charN++) {
+			uint32_t *adjacentList = &table.neighbors[table.getCell(layerN, charN) * SIDES];
+
+			cellCoordinates neighbors[SIDES];
+			getNeighborCoordinates(layerCount, { (uint32_t)layerN, (uint32_t)charN }, neighbors);
+			for (size_t neighborN = 0; neighborN < SIDES; neighborN++) {
+				if (neighbors[neighborN].layerN == NO_CELL) continue;
+				adjacentList[neighborN] = table.getCell(neighbors[neighborN].layerN, neighbors[neighborN].charN);
+			}
+		}
+	}
+}
+
+/*
+ * Function name: setAdjacentLetters(table)
+ * Sets the adjacency bigram bitmap of the cell table from its neighbors
+ * WARNING: neighbors must be set first!
+ */
+template<size_t adjacentN>
+inline void setAdjacentLetters(cellTable<adjacentN> &table) {
+	for (size_t bucket = 0; bucket < ALPHABET; bucket++) {
+		table.adjacentLetters[bucket] = 0;
+	}
+
+	for (uint32_t cell = 0; cell < table.getCellCount(); cell++) {
+		size_t bucket = getBucket(table.letters[cell]);
+		if (bucket >= ALPHABET) continue;
+
+		for (size_t neighborN = 0; neighborN < adjacentN; neighborN++) {
+			uint32_t neighbor = table.getNeighbor(cell, neighborN);
+			if (neighbor == NO_CELL) continue;
+
+			size_t neighborBucket = getBucket(table.letters[neighbor]);
+			if (neighborBucket < ALPHABET) table.adjacentLetters[bucket] |= 1u << neighborBucket;
+		}
+	}
+}
+
+/*
+ * Function name: setNeighborLetters(table)
+ * Packs the letters of the neighbors of every cell of the cell table
+ * WARNING: neighbors must be set first!
+ */
+template<size_t adjacentN>
+inline void setNeighborLetters(cellTable<adjacentN> &table) {
+	for (uint32_t cell = 0; cell < table.getCellCount(); cell++) {
+		uint64_t packed = 0;
+		for (size_t neighborN = 0; neighborN < adjacentN; neighborN++) {
+			uint32_t neighbor = table.getNeighbor(cell, neighborN);
+			if (neighbor != NO_CELL) packed |= (uint64_t)(unsigned char)table.letters[neighbor] << (8 * neighborN);
+		}
+		table.neighborLetters[cell] = packed;
+	}
+}
+
+/*
+ * Function name: getMatchSlot(matches)
+ * Returns the neighbor slot of the lowest match in a mask returned
+ * by getMatchingNeighbors()
+ */
+const inline size_t getMatchSlot(const uint64_t matches) {
+	return __builtin_ctzll(matches) >> 3;
+}
+
+/*
+ * Function name: buildCellTable(layers, table)
+ * Fills a cell table from the layers of a honeycomb and sets
+ * its neighbors, packed neighbor letters and adjacency bigram bitmap
+ */
+inline void buildCellTable(const std::vector<std::string_view> &layers, cellTable<SIDES> &table) {
+	populateCellTable(layers, table);
+	setNeighbors(table);
+	setNeighborLetters(table);
+	setAdjacentLetters(table);
+}
+
+/*
+ * Function name: setCellLetter(table, cell, value)
+ * Changes the letter of a given cell of a built cell table in place,
+ * without rebuilding it: the cell is moved to the bucket of its new
+ * letter (keeping the buckets in id order) and the packed letters of
+ * its neighbors are patched. The adjacency bigram bitmap gains the
+ * pairs of the new letter but keeps those of the old one, so it stays
+ * a superset of the pairs on the board, which is all the letter filter
+ * needs.
+ */
+template<size_t adjacentN>
+inline void setCellLetter(cellTable<adjacentN> &table, const uint32_t cell, const char value) {
+	char previous = table.letters[cell];
+	if (previous == value) return;
+	uint32_t *cellsEnd = table.bucketCells + table.bucketStart[ALPHABET];
+
+	//take the cell out of its bucket, closing the gap
+	size_t bucket = getBucket(previous);
+	if (bucket < ALPHABET) {
+		uint32_t *position = std::lower_bound(table.bucketCells + table.bucketStart[bucket], table.bucketCells + table.bucketStart[bucket + 1], cell);
+		std::copy(position + 1, cellsEnd, position);
+		cellsEnd--;
+		for (size_t later = bucket + 1; later <= ALPHABET; later++) table.bucketStart[later]--;
+	}
+
+	//and put it into the bucket of its new letter, opening one
+	bucket = getBucket(value);
+	if (bucket < ALPHABET) {
+		uint32_t *position = std::lower_bound(table.bucketCells + table.bucketStart[bucket], table.bucketCells + table.bucketStart[bucket + 1], cell);
+		std::copy_backward(position, cellsEnd, cellsEnd + 1);
+		*position = cell;
+		for (size_t later = bucket + 1; later <= ALPHABET; later++) table.bucketStart[later]++;
+	}
+	table.letters[cell] = value;
+
+	for (size_t neighborN = 0; neighborN < adjacentN; neighborN++) {
+		uint32_t neighbor = table.getNeighbor(cell, neighborN);
+		if (neighbor == NO_CELL) continue;
+
+		//patch the slot of the neighbor that points back at the cell
+		for (size_t slot = 0; slot < adjacentN; slot++) {
+			if (table.getNeighbor(neighbor, slot) != cell) continue;
+			table.neighborLetters[neighbor] &= ~((uint64_t)0xFF << (8 * slot));
+			table.neighborLetters[neighbor] |= (uint64_t)(unsigned char)value << (8 * slot);
+		}
+
+		size_t neighborBucket = getBucket(table.letters[neighbor]);
+		if (bucket < ALPHABET && neighborBucket < ALPHABET) {
+			table.adjacentLetters[bucket] |= 1u << neighborBucket;
+			table.adjacentLetters[neighborBucket] |= 1u << bucket;
+		}
+	}
+}
+
+#endif
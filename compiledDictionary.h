@@ -0,0 +1,285 @@
+/*
+ * File: compiledDictionary.h
+ * -------------------------
+ * Binary precompiled form of a dictionary: a minimised trie
+ * (a DAWG, in which identical suffixes are shared) stored as
+ * a flat array of nodes that is searched straight out of a
+ * memory mapping of the file, without deserialising it.
+ * Words are identified by their rank in sorted order, which
+ * is computed from the word counts kept in the nodes while
+ * walking, and turned back into letters only when printed.
+ * The file is written in the byte order of the machine.
+ */
+
+#ifndef COMPILED_DICTIONARY_H
+#define COMPILED_DICTIONARY_H
+
+/* Packages */
+#include <map>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cellTable.h"
+#include "dictionaryTrie.h"
+#include "searchStats.h"
+
+/* Macros */
+#define COMPILED_MAGIC "HEXDAWG1"
+#define TERMINAL_BIT 0x80000000u
+
+/*
+ * Struct defining the header at the start of a compiled dictionary,
+ * followed by nodeCount nodes, the root first.
+ */
+struct compiledHeader
+{
+	char magic[8];
+	uint32_t nodeCount;
+	uint32_t wordCount;
+	uint32_t maxLength;
+	uint32_t reserved;
+};
+
+/*
+ * Struct defining a node of a compiled dictionary. As in a
+ * dictionaryTrie, the children of a node are adjacent and found by
+ * counting the bits of the child mask below a letter, but a block of
+ * children may be shared by every node with the same suffixes.
+ * A node keeps the number of words at or below it, and the number of
+ * words below the siblings before it in its block, so the rank of a
+ * word is the sum of the offsets along its path.
+ * Blocks are written after the blocks of their children, so every
+ * node but the root comes after its children.
+ */
+struct compiledNode
+{
+	uint32_t childMask; //terminal nodes also have TERMINAL_BIT set
+	uint32_t firstChild;
+	uint32_t rankOffset; //words below the earlier siblings
+	uint32_t wordCount; //words at or below this node
+};
+
+/*
+ * Struct viewing a compiled dictionary in memory, such as a mapping
+ * of its file. The memory is not owned and must outlive the view.
+ */
+struct compiledDictionary
+{
+	/* Data */
+	const compiledNode *nodes = NULL;
+	size_t nodeCount = 0;
+	size_t wordCount = 0;
+	size_t maxLength = 0;
+
+	/* Functions */
+	bool isOpen() const {
+		return nodes != NULL;
+	}
+
+	//views a compiled dictionary in a given buffer, setting error and returning false if it is not one or is corrupt
+	bool open(const char *data, const size_t size, std::string &error) {
+		compiledHeader header;
+		if (size < sizeof(header) || memcmp(data, COMPILED_MAGIC, sizeof(header.magic)) != 0) {
+			error = "not a compiled dictionary";
+			return false;
+		}
+		memcpy(&header, data, sizeof(header));
+		if (header.nodeCount == 0 || (size - sizeof(header)) / sizeof(compiledNode) < header.nodeCount) {
+			error = "compiled dictionary is truncated";
+			return false;
+		}
+
+		const compiledNode *viewed = (const compiledNode *)(data + sizeof(header));
+		if (header.maxLength > header.nodeCount || viewed[0].wordCount != header.wordCount || !isWellFormed(viewed, header.nodeCount)) {
+			error = "compiled dictionary is corrupt";
+			return false;
+		}
+
+		nodes = viewed;
+		nodeCount = header.nodeCount;
+		wordCount = header.wordCount;
+		maxLength = header.maxLength;
+		return true;
+	}
+
+	//returns whether the children of every node are in bounds and come before it, and their word counts partition its own
+	static bool isWellFormed(const compiledNode *nodes, const size_t nodeCount) {
+		for (size_t nodeN = 0; nodeN < nodeCount; nodeN++) {
+			const compiledNode &node = nodes[nodeN];
+			uint32_t letters = node.childMask & ~TERMINAL_BIT;
+			uint64_t terminal = (node.childMask & TERMINAL_BIT) != 0;
+			if ((letters >> ALPHABET) != 0) return false;
+			if (letters == 0) {
+				if (node.wordCount != terminal) return false;
+				continue;
+			}
+
+			uint64_t begin = node.firstChild;
+			uint64_t end = begin + __builtin_popcount(letters);
+			if (begin == 0 || end > (nodeN == 0 ? nodeCount : nodeN)) return false;
+
+			uint64_t words = 0; //below the earlier siblings
+			for (uint64_t child = begin; child < end; child++) {
+				if (nodes[child].rankOffset != words) return false;
+				words += nodes[child].wordCount;
+			}
+			if (words + terminal != node.wordCount) return false;
+		}
+		return true;
+	}
+
+	bool isTerminal(const uint32_t nodeIndex) const {
+		return nodes[nodeIndex].childMask & TERMINAL_BIT;
+	}
+
+	//returns the index of the child of a node for a given letter, or 0 if none (root is never a child)
+	uint32_t getChild(const uint32_t nodeIndex, const char value) const {
+		size_t bucket = getBucket(value);
+		if (bucket >= ALPHABET) return 0;
+
+		const compiledNode &node = nodes[nodeIndex];
+		uint32_t bit = 1u << bucket;
+		if ((node.childMask & bit) == 0) return 0;
+		return node.firstChild + __builtin_popcount(node.childMask & (bit - 1));
+	}
+
+	//sets a given string to the word of a given rank
+	void getWord(size_t rank, std::string &word) const {
+		word.clear();
+		uint32_t nodeIndex = 0;
+		while (true) {
+			const compiledNode &node = nodes[nodeIndex];
+			if (node.childMask & TERMINAL_BIT) {
+				if (rank == 0) return;
+				rank--;
+			}
+
+			//find the child whose words hold the rank
+			uint32_t child = node.firstChild;
+			for (uint32_t mask = node.childMask & ~TERMINAL_BIT; mask != 0; mask &= mask - 1, child++) {
+				if (rank < nodes[child].rankOffset + nodes[child].wordCount) {
+					word.push_back('A' + __builtin_ctz(mask));
+					break;
+				}
+			}
+			rank -= nodes[child].rankOffset;
+			nodeIndex = child;
+		}
+	}
+};
+
+/*
+ * Function name: compileDictionary(dictionary, data)
+ * Sets a given buffer to the compiled form of a given dictionary.
+ * The prefix trie of the dictionary (see buildTrie()) is minimised
+ * bottom-up: the nodes are visited in reverse breadth-first order,
+ * so children come before their parents, and every block of children
+ * is looked up by its contents and only written out the first time
+ * it is seen. Only the words buildTrie() keeps are compiled, once each.
+ */
+inline void compileDictionary(const std::vector<std::string_view> &dictionary, std::vector<char> &data) {
+	dictionaryTrie trie;
+	buildTrie(dictionary, trie);
+
+	size_t maxLength = 0;
+	for (std::string_view word : dictionary) {
+		if (isWord(word)) maxLength = std::max(maxLength, word.length());
+	}
+
+	std::vector<compiledNode> compiled(1); //root, filled in last
+	std::vector<compiledNode> record(trie.nodes.size()); //node each trie node is compiled to
+	std::map<std::vector<uint32_t>, uint32_t> blocks; //contents of each block written to its first node
+	std::vector<uint32_t> key;
+
+	for (size_t nodeN = trie.nodes.size(); nodeN-- > 0;) {
+		const dictionaryTrie::trieNode &node = trie.nodes[nodeN];
+		compiledNode &current = record[nodeN];
+		current.childMask = node.childMask | (node.wordIndex >= 0 ? TERMINAL_BIT : 0);
+		current.wordCount = node.wordIndex >= 0;
+		if (node.childMask == 0) continue; //leaf
+
+		//lay out the block of children, counting the words below the earlier siblings
+		size_t childCount = __builtin_popcount(node.childMask);
+		key.clear();
+		for (size_t childN = 0; childN < childCount; childN++) {
+			compiledNode &child = record[node.firstChild + childN];
+			child.rankOffset = current.wordCount - (node.wordIndex >= 0);
+			current.wordCount += child.wordCount;
+			key.insert(key.end(), { child.childMask, child.firstChild, child.wordCount });
+		}
+
+		auto block = blocks.find(key);
+		if (block == blocks.end()) {
+			block = blocks.emplace(key, compiled.size()).first;
+			for (size_t childN = 0; childN < childCount; childN++) {
+				compiled.push_back(record[node.firstChild + childN]);
+			}
+		}
+		current.firstChild = block->second;
+	}
+	compiled[0] = record[0];
+
+	compiledHeader header;
+	memcpy(header.magic, COMPILED_MAGIC, sizeof(header.magic));
+	header.nodeCount = compiled.size();
+	header.wordCount = compiled[0].wordCount;
+	header.maxLength = maxLength;
+	header.reserved = 0;
+
+	data.resize(sizeof(header) + compiled.size() * sizeof(compiledNode));
+	memcpy(data.data(), &header, sizeof(header));
+	memcpy(data.data() + sizeof(header), compiled.data(), compiled.size() * sizeof(compiledNode));
+}
+
+/*
+ * Function name: searchCompiled(table, dictionary, nodeIndex, rank, cell, visited, foundFlags, stats)
+ * Same as searchTrie() over a compiled dictionary, flagging words by
+ * their rank. The rank of the word ending at a node is the number of
+ * words sorting before it, accumulated from the root.
+ */
+template<bool countStats = false, size_t adjacentN>
+inline void searchCompiled(const cellTable<adjacentN> &table, const compiledDictionary &dictionary, const uint32_t nodeIndex, const uint32_t rank, const uint32_t cell, visitedSet &visited, std::vector<bool> &foundFlags, searchStats *stats = NULL) {
+	const compiledNode &node = dictionary.nodes[nodeIndex];
+	bool terminal = node.childMask & TERMINAL_BIT;
+	if (terminal) foundFlags[rank] = true; //found!
+	if ((node.childMask & ~TERMINAL_BIT) == 0) return; //no longer prefix in dictionary
+
+	visited.set(cell);
+	if (countStats) {
+		stats->enter();
+		stats->visits++;
+	}
+
+	for (size_t neighborN = 0; neighborN < adjacentN; neighborN++) { //iterate over neighbors
+		uint32_t neighbor = table.getNeighbor(cell, neighborN);
+		if (neighbor == NO_CELL) continue;
+
+		uint32_t child = visited.test(neighbor) ? 0 : dictionary.getChild(nodeIndex, table.letters[neighbor]);
+		if (child != 0) searchCompiled<countStats>(table, dictionary, child, rank + terminal + dictionary.nodes[child].rankOffset, neighbor, visited, foundFlags, stats); //depth-first recursion
+		else if (countStats) stats->pruned++;
+	}
+
+	//reset and back-track
+	visited.reset(cell);
+	if (countStats) stats->leave();
+}
+
+/*
+ * Function name: searchCompiledCells(table, dictionary, begin, end, visited, foundFlags, stats)
+ * Starts a search of a compiled dictionary from every cell with an id in [begin, end)
+ */
+template<bool countStats = false, size_t adjacentN>
+inline void searchCompiledCells(const cellTable<adjacentN> &table, const compiledDictionary &dictionary, const uint32_t begin, const uint32_t end, visitedSet &visited, std::vector<bool> &foundFlags, searchStats *stats = NULL) {
+	for (uint32_t cell = begin; cell < end; cell++) {
+		uint32_t child = dictionary.getChild(0, table.letters[cell]);
+		if (child == 0) continue;
+
+		if (countStats) stats->starts++;
+		searchCompiled<countStats>(table, dictionary, child, dictionary.isTerminal(0) + dictionary.nodes[child].rankOffset, cell, visited, foundFlags, stats);
+	}
+}
+
+#endif
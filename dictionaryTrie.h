@@ -0,0 +1,171 @@
+/*
+ * File: dictionaryTrie.h
+ * -------------------------
+ * Prefix trie of the dictionary words and the trie-guided
+ * search that walks the honeycomb once, starting from every
+ * cell and following the trie alongside the path so that
+ * branches are pruned as soon as no dictionary word starts
+ * with the letters on the path.
+ */
+
+#ifndef DICTIONARY_TRIE_H
+#define DICTIONARY_TRIE_H
+
+/* Packages */
+#include <algorithm>
+#include <queue>
+#include <stdint.h>
+#include <string_view>
+#include <vector>
+
+#include "cellTable.h"
+#include "searchStats.h"
+
+/*
+ * Struct defining a prefix trie of dictionary words.
+ * The nodes are stored contiguously in breadth-first order so
+ * that the children of a node are adjacent to each other.
+ * Each node keeps a bitmask of the letters it has children for
+ * and the index of its first child, so the child for a letter
+ * is found by counting the set bits below that letter.
+ * Terminal nodes keep the index of their word in the dictionary.
+ */
+struct dictionaryTrie
+{
+	/* Types */
+	struct trieNode
+	{
+		uint32_t childMask = 0;
+		uint32_t firstChild = 0;
+		int32_t wordIndex = -1;
+	};
+
+	/* Data */
+	std::vector<trieNode> nodes;
+
+	/* Functions */
+	//returns the index of the child of a node for a given letter, or 0 if none (root is never a child)
+	uint32_t getChild(const uint32_t nodeIndex, const char value) const {
+		size_t bucket = getBucket(value);
+		if (bucket >= ALPHABET) return 0;
+
+		const trieNode &node = nodes[nodeIndex];
+		uint32_t bit = 1u << bucket;
+		if ((node.childMask & bit) == 0) return 0;
+		return node.firstChild + __builtin_popcount(node.childMask & (bit - 1));
+	}
+};
+
+/*
+ * Function name: isWord(word)
+ * Returns whether a given string is a non-empty word of capital letters
+ */
+const inline bool isWord(const std::string_view word) {
+	if (word.empty()) return false;
+	for (size_t charN = 0; charN < word.length(); charN++) {
+		if (getBucket(word[charN]) >= ALPHABET) return false;
+	}
+	return true;
+}
+
+/*
+ * Function name: buildTrie(dictionary, trie)
+ * Fills a prefix trie with the words of a given dictionary.
+ * The words are sorted first so that the words below any trie node
+ * form a contiguous range, then the trie is built breadth-first by
+ * splitting each range on the letter at the current depth.
+ * Words containing anything but capital letters are skipped and
+ * duplicate words share a node (the first occurrence is kept).
+ */
+inline void buildTrie(const std::vector<std::string_view> &dictionary, dictionaryTrie &trie) {
+	std::vector<uint32_t> order; //indices of valid words sorted by word
+	order.reserve(dictionary.size());
+	for (size_t wordN = 0; wordN < dictionary.size(); wordN++) {
+		if (isWord(dictionary[wordN])) order.push_back(wordN);
+	}
+	std::stable_sort(order.begin(), order.end(), [&dictionary](uint32_t a, uint32_t b) { return dictionary[a] < dictionary[b]; });
+
+	struct trieRange { uint32_t nodeIndex; size_t begin; size_t end; size_t depth; };
+	std::queue<trieRange> pending;
+
+	trie.nodes.clear();
+	trie.nodes.push_back(dictionaryTrie::trieNode()); //root
+	pending.push({ 0, 0, order.size(), 0 });
+
+	while (!pending.empty()) {
+		trieRange range = pending.front();
+		pending.pop();
+
+		//words ending at this depth sort before their extensions
+		size_t begin = range.begin;
+		if (begin < range.end && dictionary[order[begin]].length() == range.depth) {
+			trie.nodes[range.nodeIndex].wordIndex = order[begin];
+			while (begin < range.end && dictionary[order[begin]].length() == range.depth) begin++;
+		}
+		if (begin == range.end) continue; //leaf
+
+		//split the rest on the letter at this depth, allocating the children contiguously
+		trie.nodes[range.nodeIndex].firstChild = trie.nodes.size();
+		while (begin < range.end) {
+			char value = dictionary[order[begin]][range.depth];
+			size_t end = begin;
+			while (end < range.end && dictionary[order[end]][range.depth] == value) end++;
+
+			trie.nodes[range.nodeIndex].childMask |= 1u << getBucket(value);
+			pending.push({ (uint32_t)trie.nodes.size(), begin, end, range.depth + 1 });
+			trie.nodes.push_back(dictionaryTrie::trieNode());
+			begin = end;
+		}
+	}
+}
+
+/*
+ * Function name: searchTrie(table, trie, nodeIndex, cell, visited, foundFlags, stats)
+ * Flags every dictionary word that can be formed by extending the path
+ * ending at a given cell, whose letters lead to the given trie node.
+ * Recursive depth-first search over the neighbors that continue a
+ * dictionary prefix; branches without a matching trie child are pruned.
+ * With countStats set, the search is counted in the given stats.
+ */
+template<bool countStats = false, size_t adjacentN>
+inline void searchTrie(const cellTable<adjacentN> &table, const dictionaryTrie &trie, const uint32_t nodeIndex, const uint32_t cell, visitedSet &visited, std::vector<bool> &foundFlags, searchStats *stats = NULL) {
+	const dictionaryTrie::trieNode &node = trie.nodes[nodeIndex];
+	if (node.wordIndex >= 0) foundFlags[node.wordIndex] = true; //found!
+	if (node.childMask == 0) return; //no longer prefix in dictionary
+
+	visited.set(cell);
+	if (countStats) {
+		stats->enter();
+		stats->visits++;
+	}
+
+	for (size_t neighborN = 0; neighborN < adjacentN; neighborN++) { //iterate over neighbors
+		uint32_t neighbor = table.getNeighbor(cell, neighborN);
+		if (neighbor == NO_CELL) continue;
+
+		uint32_t child = visited.test(neighbor) ? 0 : trie.getChild(nodeIndex, table.letters[neighbor]);
+		if (child != 0) searchTrie<countStats>(table, trie, child, neighbor, visited, foundFlags, stats); //depth-first recursion
+		else if (countStats) stats->pruned++;
+	}
+
+	//reset and back-track
+	visited.reset(cell);
+	if (countStats) stats->leave();
+}
+
+/*
+ * Function name: searchCells(table, trie, begin, end, visited, foundFlags, stats)
+ * Starts a trie-guided search from every cell with an id in [begin, end)
+ */
+template<bool countStats = false, size_t adjacentN>
+inline void searchCells(const cellTable<adjacentN> &table, const dictionaryTrie &trie, const uint32_t begin, const uint32_t end, visitedSet &visited, std::vector<bool> &foundFlags, searchStats *stats = NULL) {
+	for (uint32_t cell = begin; cell < end; cell++) {
+		uint32_t child = trie.getChild(0, table.letters[cell]);
+		if (child == 0) continue;
+
+		if (countStats) stats->starts++;
+		searchTrie<countStats>(table, trie, child, cell, visited, foundFlags, stats);
+	}
+}
+
+#endif
@@ -0,0 +1,183 @@
+/*
+ * File: generateInput.cpp
+ * -------------------------
+ * Generates synthetic inputs for benchmarking hexagonalSearch:
+ * random honeycombs of a given number of layers and random
+ * dictionaries of a given size and word length, with letters
+ * drawn from a configurable distribution. Dictionaries can be
+ * seeded with words read off random paths of a honeycomb so
+ * that a chosen fraction of them is found.
+ * Output is written to standard output in the input formats
+ * of hexagonalSearch. The same seed gives the same output.
+ */
+
+/* Packages */
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cellTable.h"
+#include "mappedFile.h"
+#include "randomInput.h"
+
+/* Namespace */
+using namespace std;
+
+/*
+ * Struct holding the options given on the command line.
+ */
+struct generatorOptions
+{
+	string kind; //honeycomb or dictionary
+	string letters = "uniform"; //uniform, english or skewed
+	size_t seed = 1;
+	size_t layers = 5;
+	size_t words = 1000;
+	size_t minLength = 3;
+	size_t maxLength = 10;
+	const char *board = NULL; //honeycomb to read hits from
+	double hits = 0; //fraction of words read off paths of the board
+	bool sorted = false;
+};
+
+/*
+ * Function name: printUsage(program)
+ * Prints the command line usage to standard error
+ */
+void printUsage(const char *program) {
+	cerr << "Usage: " << program << " honeycomb [--layers N] [--letters uniform|english|skewed] [--seed S]" << endl;
+	cerr << "       " << program << " dictionary [--words N] [--min-length N] [--max-length N] [--letters uniform|english|skewed]" << endl;
+	cerr << "       " << string(strlen(program), ' ') << "            [--seed S] [--board honeycomb.txt --hits FRACTION] [--sorted]" << endl;
+}
+
+/*
+ * Function name: parseOptions(argc, argv, options)
+ * Parses the command line into a given options struct.
+ * Returns false if the command line is invalid.
+ */
+bool parseOptions(int argc, char **argv, generatorOptions &options) {
+	if (argc < 2) return false;
+	options.kind = argv[1];
+	if (options.kind != "honeycomb" && options.kind != "dictionary") return false;
+
+	for (int argn = 2; argn < argc; argn++) {
+		string option = argv[argn];
+		if (option == "--sorted") {
+			options.sorted = true;
+			continue;
+		}
+
+		if (++argn == argc) return false;
+		const char *value = argv[argn];
+		if (option == "--letters") options.letters = value;
+		else if (option == "--seed") options.seed = strtoul(value, NULL, 10);
+		else if (option == "--layers") options.layers = strtoul(value, NULL, 10);
+		else if (option == "--words") options.words = strtoul(value, NULL, 10);
+		else if (option == "--min-length") options.minLength = strtoul(value, NULL, 10);
+		else if (option == "--max-length") options.maxLength = strtoul(value, NULL, 10);
+		else if (option == "--board") options.board = value;
+		else if (option == "--hits") options.hits = strtod(value, NULL);
+		else return false;
+	}
+
+	if (options.letters != "uniform" && options.letters != "english" && options.letters != "skewed") return false;
+	return options.minLength > 0 && options.minLength <= options.maxLength;
+}
+
+/*
+ * Function name: generateHoneycomb(options, random)
+ * Writes a random honeycomb to standard output
+ */
+void generateHoneycomb(const generatorOptions &options, mt19937_64 &random) {
+	discrete_distribution<size_t> letter = makeLetterDistribution(options.letters);
+
+	cout << options.layers << '\n';
+	string layer;
+	for (size_t layerN = 0; layerN < options.layers; layerN++) {
+		layer.resize(getLayerSize(layerN));
+		for (size_t charN = 0; charN < layer.length(); charN++) {
+			layer[charN] = 'A' + letter(random);
+		}
+		cout << layer << '\n';
+	}
+}
+
+/*
+ * Function name: generateDictionary(options, random)
+ * Writes a random dictionary to standard output.
+ * Returns false if the board to read hits from cannot be read.
+ */
+bool generateDictionary(const generatorOptions &options, mt19937_64 &random) {
+	discrete_distribution<size_t> letter = makeLetterDistribution(options.letters);
+	uniform_int_distribution<size_t> length(options.minLength, options.maxLength);
+	bernoulli_distribution hit(options.hits);
+
+	//optional board to read words off, so that some are found
+	mappedFile boardFile;
+	vector<string_view> layers;
+	cellTable<SIDES> table;
+	if (options.board != NULL) {
+		string error;
+		if (!boardFile.open(options.board, error)) {
+			cerr << error << endl;
+			return false;
+		}
+		splitLines(boardFile.data, boardFile.size, layers);
+		if (!layers.empty()) layers.erase(layers.begin()); //layer count
+		if (layers.empty() || !isHoneycomb(layers)) {
+			cerr << options.board << ": not a honeycomb" << endl;
+			return false;
+		}
+		buildCellTable(layers, table);
+	}
+
+	vector<string> words(options.words);
+	for (size_t wordN = 0; wordN < options.words; wordN++) {
+		string &word = words[wordN];
+		size_t wordLength = length(random);
+
+		if (options.board != NULL && hit(random)) {
+			for (size_t tries = 0; tries < 100; tries++) {
+				if (readPathWord(table, wordLength, random, word)) break;
+			}
+			if (word.length() == wordLength) continue;
+		}
+
+		word.resize(wordLength);
+		for (size_t charN = 0; charN < wordLength; charN++) {
+			word[charN] = 'A' + letter(random);
+		}
+	}
+
+	if (options.sorted) sort(words.begin(), words.end());
+	for (const string &word : words) {
+		cout << word << '\n';
+	}
+	return true;
+}
+
+/*
+ * Function name: main(argc, argv)
+ * Example usage: "./generateInput honeycomb --layers 200 --letters english > honeycomb.txt"
+ * and "./generateInput dictionary --words 100000 --board honeycomb.txt --hits 0.2 > dictionary.txt"
+ */
+int main(int argc, char **argv) {
+	generatorOptions options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	ios::sync_with_stdio(false);
+	mt19937_64 random(options.seed);
+
+	if (options.kind == "honeycomb") generateHoneycomb(options, random);
+	else if (!generateDictionary(options, random)) return 1;
+
+	return 0;
+}
@@ -0,0 +1,160 @@
+/*
+ * File: gridTopology.h
+ * -------------------------
+ * Board topologies as compile-time policies. A policy gives
+ * the number of neighbor slots of a cell, which the cell table
+ * and the search kernels are instantiated with so that every
+ * board type gets its own fully unrolled neighbor loops, along
+ * with the shape its lines must have, the function that sets
+ * the neighbors of a populated cell table and the coordinates
+ * of its cells.
+ * Besides the honeycomb, boards can be square grids with 4 or 8
+ * neighbors per cell or triangular grids with 3. Their lines are
+ * rows of equal length, as many as the count on the first line,
+ * and their cells are numbered row by row.
+ */
+
+#ifndef GRID_TOPOLOGY_H
+#define GRID_TOPOLOGY_H
+
+/* Packages */
+#include <stdint.h>
+#include <string_view>
+#include <vector>
+
+#include "cellTable.h"
+
+/*
+ * Function name: isRectangle(rows)
+ * Returns whether the given rows are non-empty and all of the same length
+ */
+inline bool isRectangle(const std::vector<std::string_view> &rows) {
+	for (size_t rowN = 0; rowN < rows.size(); rowN++) {
+		if (rows[rowN].empty() || rows[rowN].length() != rows[0].length()) return false;
+	}
+	return true;
+}
+
+/*
+ * Function name: setOffsetNeighbors(table, offsets)
+ * Sets the neighbor ids of all cells of a cell table populated from
+ * rows of equal length, slot n of a cell being the cell offsets[n]
+ * rows and columns away from it, if it is on the board
+ */
+template<size_t adjacentN>
+inline void setOffsetNeighbors(cellTable<adjacentN> &table, const int offsets[adjacentN][2]) {
+	int64_t rowCount = table.getLayerCount();
+	int64_t columnCount = rowCount == 0 ? 0 : table.getCellCount() / rowCount;
+	for (int64_t rowN = 0; rowN < rowCount; rowN++) {
+		for (int64_t columnN = 0; columnN < columnCount; columnN++) {
+			uint32_t *adjacentList = &table.neighbors[(rowN * columnCount + columnN) * adjacentN];
+			for (size_t neighborN = 0; neighborN < adjacentN; neighborN++) {
+				int64_t neighborRow = rowN + offsets[neighborN][0];
+				int64_t neighborColumn = columnN + offsets[neighborN][1];
+				if (neighborRow < 0 || neighborRow >= rowCount || neighborColumn < 0 || neighborColumn >= columnCount) continue;
+				adjacentList[neighborN] = neighborRow * columnCount + neighborColumn;
+			}
+		}
+	}
+}
+
+/*
+ * Function name: getRowCoordinates(table, cell)
+ * Returns the row and column, as layer and char, of the cell with a
+ * given id in a cell table populated from rows of equal length
+ */
+template<size_t adjacentN>
+inline cellCoordinates getRowCoordinates(const cellTable<adjacentN> &table, const uint32_t cell) {
+	size_t columnCount = table.getCellCount() / table.getLayerCount();
+	return { (uint32_t)(cell / columnCount), (uint32_t)(cell % columnCount) };
+}
+
+/*
+ * Struct defining the honeycomb topology of cellTable.h: layers
+ * of hexagonal cells around a central one, six neighbors each.
+ */
+struct hexGrid
+{
+	static constexpr size_t adjacentN = SIDES;
+	static constexpr const char *name = "hex";
+	static constexpr const char *shapeError = "layer sizes do not form a honeycomb";
+
+	static bool isBoard(const std::vector<std::string_view> &layers) {
+		return isHoneycomb(layers);
+	}
+
+	static void setNeighbors(cellTable<adjacentN> &table) {
+		::setNeighbors(table);
+	}
+
+	static cellCoordinates getCoordinates(const cellTable<adjacentN> &/*table*/, const uint32_t cell) {
+		return getCellCoordinates(cell);
+	}
+};
+
+/*
+ * Struct defining a square grid, whose cells neighbor the cells
+ * above, left, right and below them, and with diagonal set also
+ * the four cells touching their corners. Neighbors come in
+ * ascending order of id.
+ */
+template<bool diagonal>
+struct squareGrid
+{
+	static constexpr size_t adjacentN = diagonal ? 8 : 4;
+	static constexpr const char *name = diagonal ? "square8" : "square4";
+	static constexpr const char *shapeError = "rows are not all of the same length";
+
+	static bool isBoard(const std::vector<std::string_view> &rows) {
+		return isRectangle(rows);
+	}
+
+	static void setNeighbors(cellTable<adjacentN> &table) {
+		static const int sideOffsets[4][2] = { { -1, 0 }, { 0, -1 }, { 0, 1 }, { 1, 0 } };
+		static const int kingOffsets[8][2] = { { -1, -1 }, { -1, 0 }, { -1, 1 }, { 0, -1 }, { 0, 1 }, { 1, -1 }, { 1, 0 }, { 1, 1 } };
+		if constexpr (diagonal) setOffsetNeighbors(table, kingOffsets);
+		else setOffsetNeighbors(table, sideOffsets);
+	}
+
+	static cellCoordinates getCoordinates(const cellTable<adjacentN> &table, const uint32_t cell) {
+		return getRowCoordinates(table, cell);
+	}
+};
+
+/*
+ * Struct defining a triangular grid, whose cells alternate between
+ * pointing up and down along each row, starting up in the top left
+ * corner. A cell neighbors the cells on its left and right and the
+ * one across its horizontal edge: below it if it points up, above
+ * it otherwise.
+ */
+struct triangleGrid
+{
+	static constexpr size_t adjacentN = 3;
+	static constexpr const char *name = "triangle";
+	static constexpr const char *shapeError = "rows are not all of the same length";
+
+	static bool isBoard(const std::vector<std::string_view> &rows) {
+		return isRectangle(rows);
+	}
+
+	static void setNeighbors(cellTable<adjacentN> &table) {
+		static const int offsets[3][2] = { { 0, -1 }, { 0, 1 }, { 1, 0 } };
+		setOffsetNeighbors(table, offsets); //as if every cell pointed up
+
+		//then point the cells pointing down at the row above instead
+		size_t rowCount = table.getLayerCount();
+		size_t columnCount = rowCount == 0 ? 0 : table.getCellCount() / rowCount;
+		for (size_t rowN = 0; rowN < rowCount; rowN++) {
+			for (size_t columnN = (rowN + 1) % 2; columnN < columnCount; columnN += 2) {
+				table.neighbors[(rowN * columnCount + columnN) * adjacentN + 2] = rowN == 0 ? NO_CELL : (rowN - 1) * columnCount + columnN;
+			}
+		}
+	}
+
+	static cellCoordinates getCoordinates(const cellTable<adjacentN> &table, const uint32_t cell) {
+		return getRowCoordinates(table, cell);
+	}
+};
+
+#endif
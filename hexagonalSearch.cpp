@@ -9,282 +9,1648 @@
  * in the honeycomb. Words are formed by paths through
  * adjacent cells.
  *
- * General idea: Keep a linked list of nodes that have
+ * General idea: Keep a bucket of the nodes that have
  * the value of the same letter. For each word in the
- * dictionary, iterate through the linked list of nodes
+ * dictionary, iterate through the bucket of nodes
  * and perform a depth-first search through each node's
  * neighbor looking for the next letter of the word.
  *
+ * The honeycomb is kept as a flat table of cells (see
+ * cellTable.h) so the search walks contiguous arrays of
+ * letters and neighbor ids instead of chasing pointers.
+ *
  * DFS chosen over BFS since depth is at most the length
  * of the longest word in the dictionary which is unlikely
  * to be very long. Memory usage is much lower as a result.
+ *
+ * Alternative idea (--mode trie): Build a prefix trie of
+ * the dictionary and walk the honeycomb once, starting a
+ * depth-first search from every cell and following the
+ * trie alongside the path. Branches are pruned as soon as
+ * no dictionary word starts with the letters on the path,
+ * so the cost no longer scales with the dictionary size.
+ * The trie can also be compiled ahead of time (--compile)
+ * into a file that is searched straight from its mapping.
  */
 
 /* Packages */
-#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <errno.h>
 #include <fstream>
+#include <iostream>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <new>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
 #include <vector>
 
+#include "boundedQueue.h"
+#include "bufferedWriter.h"
+#include "cellTable.h"
+#include "compiledDictionary.h"
+#include "dictionaryTrie.h"
+#include "gridTopology.h"
+#include "implicitSearch.h"
+#include "incrementalSearch.h"
+#include "lockstepSearch.h"
+#include "mappedFile.h"
+#include "neighborCache.h"
+#include "pathCount.h"
+#include "searchStats.h"
+#include "wordSearch.h"
+#include "workStealing.h"
+
 /* Namespace */
 using namespace std;
 
-/* Macros */
-#define SIDES 6
-#define ALPHABET 26
+/*
+ * Count of heap allocations made by each thread, kept by the
+ * replaced global operators new so the benchmark output can show
+ * how many allocations the searches make per query. Every form of
+ * operator new and delete is replaced, so that all allocations
+ * are counted and all memory is taken from and returned to the
+ * same allocator.
+ */
+static thread_local size_t allocationCount = 0;
+
+/*
+ * Function name: countedAlloc(size, alignment)
+ * Returns a new block of at least a given size and alignment (or
+ * that of malloc() if 0), counted in allocationCount, or NULL if
+ * there is no memory
+ */
+void * countedAlloc(const size_t size, const size_t alignment) noexcept {
+	allocationCount++;
+	if (alignment <= alignof(max_align_t)) return malloc(size == 0 ? 1 : size);
+
+	void *memory = NULL;
+	return posix_memalign(&memory, alignment, size == 0 ? 1 : size) == 0 ? memory : NULL;
+}
+
+/*
+ * Function name: countedAllocOrThrow(size, alignment)
+ * Same as countedAlloc() but throws bad_alloc if there is no memory
+ */
+void * countedAllocOrThrow(const size_t size, const size_t alignment) {
+	void *memory = countedAlloc(size, alignment);
+	if (memory == NULL) throw bad_alloc();
+	return memory;
+}
+
+void * operator new(size_t size) { return countedAllocOrThrow(size, 0); }
+void * operator new[](size_t size) { return countedAllocOrThrow(size, 0); }
+void * operator new(size_t size, align_val_t alignment) { return countedAllocOrThrow(size, (size_t)alignment); }
+void * operator new[](size_t size, align_val_t alignment) { return countedAllocOrThrow(size, (size_t)alignment); }
+void * operator new(size_t size, const nothrow_t &) noexcept { return countedAlloc(size, 0); }
+void * operator new[](size_t size, const nothrow_t &) noexcept { return countedAlloc(size, 0); }
+void * operator new(size_t size, align_val_t alignment, const nothrow_t &) noexcept { return countedAlloc(size, (size_t)alignment); }
+void * operator new[](size_t size, align_val_t alignment, const nothrow_t &) noexcept { return countedAlloc(size, (size_t)alignment); }
+
+void operator delete(void *memory) noexcept { free(memory); }
+void operator delete[](void *memory) noexcept { free(memory); }
+void operator delete(void *memory, size_t) noexcept { free(memory); }
+void operator delete[](void *memory, size_t) noexcept { free(memory); }
+void operator delete(void *memory, align_val_t) noexcept { free(memory); }
+void operator delete[](void *memory, align_val_t) noexcept { free(memory); }
+void operator delete(void *memory, size_t, align_val_t) noexcept { free(memory); }
+void operator delete[](void *memory, size_t, align_val_t) noexcept { free(memory); }
+void operator delete(void *memory, const nothrow_t &) noexcept { free(memory); }
+void operator delete[](void *memory, const nothrow_t &) noexcept { free(memory); }
+void operator delete(void *memory, align_val_t, const nothrow_t &) noexcept { free(memory); }
+void operator delete[](void *memory, align_val_t, const nothrow_t &) noexcept { free(memory); }
+
+/*
+ * Function name: parseCount(text, count)
+ * Parses a given string as an unsigned count.
+ * Returns false if the string is not a number.
+ */
+bool parseCount(const char *text, size_t &count) {
+	char *end;
+	count = strtoul(text, &end, 10);
+	return *text != '\0' && *end == '\0';
+}
+
+/*
+ * Function name: readLines(path, firstLineCount, file, lines, error)
+ * Maps the file at a given path and fills a given vector with views
+ * of its lines, which stay valid for as long as the file is mapped.
+ * An input gives the option of reading the first line as the
+ * number of lines in the file, which is then not part of the lines
+ * and must match the number of lines that follow it.
+ * Returns false and sets error if the file cannot be read.
+ */
+bool readLines(const char *path, const bool firstLineCount, mappedFile &file, vector<string_view> &lines, string &error) {
+	if (!file.open(path, error)) return false;
+	splitLines(file.data, file.size, lines);
+
+	if (firstLineCount) { //if first line gives number of lines
+		size_t lineCount;
+		if (lines.empty() || !parseCount(string(lines[0]).c_str(), lineCount)) {
+			error = string(path) + ": first line is not a line count";
+			return false;
+		}
+		lines.erase(lines.begin());
+
+		if (lines.size() != lineCount) {
+			error = string(path) + ": expected " + to_string(lineCount) + " lines but found " + to_string(lines.size());
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Function name: normaliseDictionary(dictionary, storage)
+ * Folds the words of a given dictionary to capital letters and drops
+ * repeated words, keeping the first occurrence of each in place.
+ * Only words with lowercase letters are copied, folded, into a given
+ * string, which the views then point into and which must outlive them.
+ */
+void normaliseDictionary(vector<string_view> &dictionary, string &storage) {
+	auto isLower = [](char value) { return value >= 'a' && value <= 'z'; };
+
+	//reserve all of the folded words up front, so the views into the storage stay valid
+	size_t foldedLength = 0;
+	for (string_view word : dictionary) {
+		if (any_of(word.begin(), word.end(), isLower)) foldedLength += word.length();
+	}
+	storage.clear();
+	storage.reserve(foldedLength);
+
+	for (string_view &word : dictionary) {
+		if (!any_of(word.begin(), word.end(), isLower)) continue;
+
+		size_t start = storage.size();
+		for (char value : word) {
+			storage.push_back(isLower(value) ? value - 'a' + 'A' : value);
+		}
+		word = string_view(storage.data() + start, word.length());
+	}
+
+	//sorted dictionaries hold their repeats next to each other
+	if (is_sorted(dictionary.begin(), dictionary.end())) {
+		dictionary.erase(unique(dictionary.begin(), dictionary.end()), dictionary.end());
+	} else {
+		unordered_set<string_view> seen(dictionary.size());
+		dictionary.erase(remove_if(dictionary.begin(), dictionary.end(), [&seen](string_view word) { return !seen.insert(word).second; }), dictionary.end());
+	}
+}
 
 /*
- * Struct defining a node in a polygonal structure
- * of characters. The nodes contain a value, pointers
- * to each of its adjacent nodes, and a next pointer
- * for use in linked lists.
- * The null adjacent pointers, if any exist, are not
- * necessarily at the end of the array.
- * For hexagonal polygons, the adjacents should come
- * in the predetermined order of lowest layer index to
- * greatest and lowest sublayer index to greatest.
+ * Function name: readDictionary(path, file, dictionary, storage, compiled, error)
+ * Maps the dictionary at a given path, which is either a text file
+ * of words, split into a given vector of lines and normalised (see
+ * normaliseDictionary()), or a dictionary compiled with --compile,
+ * viewed in place by a given compiled view.
+ * Returns false and sets error if the file cannot be read.
+ */
+bool readDictionary(const char *path, mappedFile &file, vector<string_view> &dictionary, string &storage, compiledDictionary &compiled, string &error) {
+	if (!file.open(path, error)) return false;
+
+	if (file.size >= strlen(COMPILED_MAGIC) && memcmp(file.data, COMPILED_MAGIC, strlen(COMPILED_MAGIC)) == 0) {
+		if (compiled.open(file.data, file.size, error)) return true;
+		error = string(path) + ": " + error;
+		return false;
+	}
+
+	splitLines(file.data, file.size, dictionary);
+	normaliseDictionary(dictionary, storage);
+	return true;
+}
+
+/*
+ * Function name: isCompiledFile(path)
+ * Returns whether the file at a given path starts like a dictionary
+ * compiled with --compile, for the modes that read the dictionary
+ * themselves rather than through readDictionary()
+ */
+bool isCompiledFile(const char *path) {
+	FILE *input = fopen(path, "rb");
+	if (input == NULL) return false;
+
+	char magic[sizeof(COMPILED_MAGIC) - 1];
+	bool compiled = fread(magic, sizeof(magic), 1, input) == 1 && memcmp(magic, COMPILED_MAGIC, sizeof(magic)) == 0;
+	fclose(input);
+	return compiled;
+}
+
+/*
+ * Function name: compileFile(dictionaryPath, outputPath, error)
+ * Compiles the text dictionary at a given path (see compileDictionary())
+ * and writes it to a given output path.
+ * Returns false and sets error if either file cannot be used.
+ */
+bool compileFile(const char *dictionaryPath, const char *outputPath, string &error) {
+	mappedFile file;
+	vector<string_view> dictionary;
+	string storage;
+	if (!readLines(dictionaryPath, false, file, dictionary, error)) return false;
+	normaliseDictionary(dictionary, storage);
+
+	vector<char> data;
+	compileDictionary(dictionary, data);
+
+	FILE *output = fopen(outputPath, "wb");
+	if (output == NULL || fwrite(data.data(), 1, data.size(), output) != data.size() || fclose(output) != 0) {
+		error = string(outputPath) + ": " + strerror(errno);
+		return false;
+	}
+	return true;
+}
+
+/*
+ * Function name: readBoard<grid>(path, lines, lineN, boardN, layers, error)
+ * Parses the next board of a given topology from the lines of a file
+ * holding any number of them one after the other, each in the format
+ * of honeycomb.txt (a layer count followed by the layers), starting at
+ * line lineN and skipping blank lines between boards. Sets a given
+ * vector to the layers of the board and advances lineN past it.
+ * Returns false at the end of the lines, or sets error (naming board
+ * boardN, counting from 1) and returns false if the board is malformed.
+ */
+template<typename grid>
+bool readBoard(const char *path, const vector<string_view> &lines, size_t &lineN, const size_t boardN, vector<string_view> &layers, string &error) {
+	while (lineN < lines.size() && lines[lineN].empty()) lineN++; //blank lines may separate boards
+	if (lineN == lines.size()) return false;
+
+	string board = string(path) + ": board " + to_string(boardN);
+	size_t layerCount;
+	if (!parseCount(string(lines[lineN]).c_str(), layerCount)) {
+		error = board + ": expected a layer count";
+		return false;
+	}
+	lineN++;
+
+	if (layerCount > lines.size() - lineN) {
+		error = board + ": expected " + to_string(layerCount) + " layers but found " + to_string(lines.size() - lineN);
+		return false;
+	}
+	layers.assign(lines.begin() + lineN, lines.begin() + lineN + layerCount);
+	lineN += layerCount;
+
+	if (!grid::isBoard(layers)) {
+		error = board + ": " + grid::shapeError;
+		return false;
+	}
+	return true;
+}
+
+/*
+ * Enum of the available search algorithms.
+ */
+enum searchMode
+{
+	WORD_MODE, //depth-first search per dictionary word (specialised for small boards)
+	TRIE_MODE, //single walk of the honeycomb guided by a dictionary trie
+	ITERATIVE_MODE, //depth-first search per dictionary word on an explicit stack
+	IMPLICIT_MODE, //trie-guided walk of the letters alone, neighbors computed on the fly
+	ANCHOR_MODE, //depth-first search per dictionary word in both directions from its rarest letter
+	LOCKSTEP_MODE, //many dictionary words at once in SIMD lanes on boards of up to 64 cells, for dictionaries mostly absent from the board
+	MODE_COUNT
+};
+
+/*
+ * Names of the search algorithms on the command line, indexed by mode.
+ */
+const char * const MODE_NAMES[MODE_COUNT] = { "word", "trie", "iterative", "implicit", "anchor", "lockstep" };
+
+/*
+ * Function name: usesTrie(mode)
+ * Returns whether a given search mode walks the board with a dictionary trie
+ */
+const inline bool usesTrie(const searchMode mode) {
+	return mode == TRIE_MODE || mode == IMPLICIT_MODE;
+}
+
+/*
+ * Enum of the available board topologies (see gridTopology.h).
+ */
+enum gridType
+{
+	HEX_GRID, //honeycomb of hexagonal cells
+	SQUARE4_GRID, //square cells sharing a side
+	SQUARE8_GRID, //square cells sharing a side or a corner
+	TRIANGLE_GRID, //triangular cells sharing a side
+	GRID_COUNT
+};
+
+/*
+ * Names of the board topologies on the command line, indexed by type.
+ */
+const char * const GRID_NAMES[GRID_COUNT] = { "hex", "square4", "square8", "triangle" };
+
+/*
+ * Struct holding the options given on the command line
+ * followed by the positional arguments.
+ */
+struct searchOptions
+{
+	searchMode mode = WORD_MODE;
+	gridType grid = HEX_GRID;
+	bool benchmark = false; //report timing and allocations to standard error
+	bool stats = false; //report per-phase timing and search counters to standard error (see printStats())
+	size_t threadCount = 1;
+	bool paths = false; //print a path of every word found (see writePaths())
+	bool count = false; //print the number of paths of every word found (see countDictionary())
+	bool letterFilter = true; //skip words that fail passesLetterFilter() in the per-word modes
+	bool server = false; //answer requests on standard input (see runServer())
+	bool stream = false; //read the dictionary in chunks (see runStream())
+	bool batch = false; //search a file of many honeycombs (see runBatch())
+	bool compile = false; //compile a dictionary instead of searching (see compileFile())
+	size_t chunkSize = 65536; //words per chunk in stream mode
+	const char *neighborsPath = NULL; //file of cached neighbor tables to load and update (see neighborCache.h)
+	vector<char *> arguments;
+};
+
+/*
+ * Function name: printUsage(program)
+ * Prints the command line usage to standard error
+ */
+void printUsage(const char *program) {
+	cerr << "Usage: " << program << " [--mode word|trie|iterative|implicit|anchor|lockstep] [--threads N] [--no-filter] [--bench] [--stats]" << endl;
+	cerr << "       " << string(strlen(program), ' ') << " [--grid hex|square4|square8|triangle] [--neighbors FILE] [--paths | --count | --stream [--chunk N]] honeycomb.txt dictionary.txt" << endl;
+	cerr << "       " << program << " --batch [--mode word|trie|iterative|implicit|anchor|lockstep] [--grid hex|square4|square8|triangle] [--neighbors FILE] [--threads N] [--no-filter] [--bench] [--stats] honeycombs.txt dictionary.txt" << endl;
+	cerr << "       " << program << " --compile dictionary.txt dictionary.dawg" << endl;
+	cerr << "       " << program << " --server [--mode word|trie|iterative|implicit|anchor|lockstep] [--neighbors FILE] [--threads N] [--no-filter] [--bench] [--stats] dictionary.txt" << endl;
+	cerr << "Lockstep mode only beats word mode on boards of at most 64 cells when few of the words are on them (see lockstepSearch.h)." << endl;
+}
+
+/*
+ * Function name: parseOptions(argc, argv, options)
+ * Parses the command line into a given options struct.
+ * Returns false if the command line is invalid. Server and implicit
+ * mode compute honeycomb coordinates, so they are hex only. Paths
+ * are only printed, and counted, for single boards searched with a
+ * cell table, as are neighbor tables cached.
+ */
+bool parseOptions(int argc, char **argv, searchOptions &options) {
+	for (int argn = 1; argn < argc; argn++) {
+		if (strcmp(argv[argn], "--mode") == 0) {
+			if (++argn == argc) return false;
+			size_t mode = 0;
+			while (mode < MODE_COUNT && strcmp(argv[argn], MODE_NAMES[mode]) != 0) mode++;
+			if (mode == MODE_COUNT) return false;
+			options.mode = (searchMode)mode;
+		} else if (strcmp(argv[argn], "--grid") == 0) {
+			if (++argn == argc) return false;
+			size_t grid = 0;
+			while (grid < GRID_COUNT && strcmp(argv[argn], GRID_NAMES[grid]) != 0) grid++;
+			if (grid == GRID_COUNT) return false;
+			options.grid = (gridType)grid;
+		} else if (strcmp(argv[argn], "--threads") == 0) {
+			if (++argn == argc || !parseCount(argv[argn], options.threadCount)) return false;
+			if (options.threadCount == 0) options.threadCount = max(1u, thread::hardware_concurrency());
+		} else if (strcmp(argv[argn], "--paths") == 0) {
+			options.paths = true;
+		} else if (strcmp(argv[argn], "--count") == 0) {
+			options.count = true;
+		} else if (strcmp(argv[argn], "--no-filter") == 0) {
+			options.letterFilter = false;
+		} else if (strcmp(argv[argn], "--stream") == 0) {
+			options.stream = true;
+		} else if (strcmp(argv[argn], "--chunk") == 0) {
+			if (++argn == argc || !parseCount(argv[argn], options.chunkSize) || options.chunkSize == 0) return false;
+		} else if (strcmp(argv[argn], "--server") == 0) {
+			options.server = true;
+		} else if (strcmp(argv[argn], "--batch") == 0) {
+			options.batch = true;
+		} else if (strcmp(argv[argn], "--compile") == 0) {
+			options.compile = true;
+		} else if (strcmp(argv[argn], "--neighbors") == 0) {
+			if (++argn == argc) return false;
+			options.neighborsPath = argv[argn];
+		} else if (strcmp(argv[argn], "--bench") == 0) {
+			options.benchmark = true;
+		} else if (strcmp(argv[argn], "--stats") == 0) {
+			options.stats = true;
+		} else if (strncmp(argv[argn], "--", 2) == 0) {
+			return false; //unknown option
+		} else {
+			options.arguments.push_back(argv[argn]);
+		}
+	}
+
+	if (options.server + options.stream + options.batch + options.compile > 1) return false;
+	if (options.grid != HEX_GRID && (options.server || options.mode == IMPLICIT_MODE)) return false;
+	if (options.paths && options.count) return false;
+	if (options.neighborsPath != NULL && (options.compile || options.mode == IMPLICIT_MODE)) return false;
+	if ((options.paths || options.count) && (options.server || options.stream || options.batch || options.mode == IMPLICIT_MODE)) return false;
+	return options.arguments.size() == (options.server ? 1 : 2);
+}
+
+/*
+ * Function name: runWorkers(threadCount, work)
+ * Runs work(threadN) for every thread number below a given count,
+ * each on its own thread (the last on the calling thread), and
+ * waits for all of them to finish.
+ */
+template<typename F>
+void runWorkers(const size_t threadCount, F work) {
+	vector<thread> workers;
+	for (size_t threadN = 0; threadN + 1 < threadCount; threadN++) {
+		workers.emplace_back(work, threadN);
+	}
+	work(threadCount - 1);
+
+	for (thread &worker : workers) {
+		worker.join();
+	}
+}
+
+/*
+ * Function name: getElapsed(start)
+ * Returns the milliseconds elapsed since a given time point
+ */
+double getElapsed(const chrono::steady_clock::time_point start) {
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+/*
+ * Struct holding the measurements of one search for the
+ * benchmark output, and the finer-grained ones for --stats.
+ */
+struct searchReport
+{
+	size_t words = 0;
+	size_t cells = 0;
+	size_t found = 0;
+	double buildTime = 0; //milliseconds
+	double searchTime = 0; //milliseconds
+	double outputTime = 0; //milliseconds, sorting and writing the words found
+	size_t allocations = 0; //made inside the search kernels
+	size_t filtered = 0; //words rejected by the letter filter
+
+	//--stats: time per phase in milliseconds, and the counters of the search kernels
+	double readTime = 0;
+	double trieTime = 0;
+	double populateTime = 0;
+	double neighborTime = 0;
+	double letterTime = 0; //neighbor letters and adjacency bitmap
+	double sortTime = 0;
+	double writeTime = 0;
+	searchStats stats;
+
+	//--stats in trie mode on several threads (see workStealing.h): per thread, the time spent running tasks
+	vector<double> busyTimes;
+	double stealingTime = 0; //milliseconds of the work-stealing searches
+	size_t tasks = 0;
+	size_t steals = 0;
+};
+
+/*
+ * Struct holding the board being searched in the representation
+ * its search mode needs: a cell table with the neighbor slots of its
+ * topology, or in implicit mode only the packed letters.
  */
 template<size_t adjacentN = SIDES>
-struct linkedPolygonNode
+struct searchBoard
 {
 	/* Data */
-	char value = 0;
-	size_t layerN = 0;
-	size_t charN = 0;
-	linkedPolygonNode * adjacentList[adjacentN] = { NULL };
-	linkedPolygonNode * nextPtr = NULL;
-	bool visited = false;
-
-	/* Functions */
-	linkedPolygonNode * getLastNode() {
-		linkedPolygonNode *current = this;
-		while (current->nextPtr != NULL) {
-			current = current->nextPtr;
+	size_t cellCount = 0;
+	cellTable<adjacentN> table;
+	implicitBoard implicit;
+};
+
+/*
+ * Function name: buildBoard<grid>(layers, options, board, report, cache)
+ * Fills a board of a given topology from its layers for the search mode
+ * chosen in the options (the steps of buildCellTable(), each timed
+ * into a given report), copying its neighbors from a given cache, if
+ * any, when a board of its size was built before
+ */
+template<typename grid>
+void buildBoard(const vector<string_view> &layers, const searchOptions &options, searchBoard<grid::adjacentN> &board, searchReport &report, neighborCache *cache = NULL) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	if (options.mode == IMPLICIT_MODE) {
+		populateImplicitBoard(layers, board.implicit);
+		board.cellCount = board.implicit.getCellCount();
+		report.populateTime += getElapsed(start);
+		return;
+	}
+
+	populateCellTable(layers, board.table);
+	board.cellCount = board.table.getCellCount();
+	report.populateTime += getElapsed(start);
+
+	start = chrono::steady_clock::now();
+	if (cache != NULL) setCachedNeighbors<grid>(board.table, *cache);
+	else grid::setNeighbors(board.table);
+	report.neighborTime += getElapsed(start);
+
+	start = chrono::steady_clock::now();
+	setNeighborLetters(board.table);
+	setAdjacentLetters(board.table);
+	report.letterTime += getElapsed(start);
+}
+
+/*
+ * Function name: searchLockstepWords(table, lockstep, dictionary, begin, end, letterFilter, visited, found, stats)
+ * Searches a cell table for the dictionary words with an index in
+ * [begin, end) in batches of lockstep searches (see lockstepSearch.h)
+ * on its lockstep board, which must be usable, adding the indices of
+ * the words found to a given vector in dictionary order. The words the
+ * lockstep search is unsure of are searched for exactly.
+ * With countStats set, both searches are counted in the given stats.
+ * Returns the number of words rejected by the letter filter, if used.
+ */
+template<bool countStats = false, size_t adjacentN>
+size_t searchLockstepWords(const cellTable<adjacentN> &table, const lockstepBoard &lockstep, const vector<string_view> &dictionary, const size_t begin, const size_t end, const bool letterFilter, visitedSet &visited, vector<uint32_t> &found, searchStats *stats = NULL) {
+	const size_t batchSize = 256;
+	string_view words[batchSize];
+	uint32_t indices[batchSize];
+	lockstepResult results[batchSize];
+
+	size_t filtered = 0;
+	size_t wordN = begin;
+	while (wordN < end) {
+		//collect a batch of the words that could be found
+		size_t count = 0;
+		for (; wordN < end && count < batchSize; wordN++) {
+			if (letterFilter && !passesLetterFilter(table, dictionary[wordN])) {
+				filtered++;
+				continue;
+			}
+			if (!isWord(dictionary[wordN])) continue;
+
+			words[count] = dictionary[wordN];
+			indices[count++] = wordN;
+		}
+
+		searchLockstep<countStats>(lockstep, words, count, results, stats);
+		for (size_t resultN = 0; resultN < count; resultN++) {
+			if (results[resultN] == LOCKSTEP_FOUND || (results[resultN] == LOCKSTEP_UNSURE && searchWordBySize<countStats>(table, words[resultN], visited, stats))) {
+				found.push_back(indices[resultN]);
+			}
 		}
-		return current;
 	}
-};
+
+	return filtered;
+}
 
 /*
- * Function name: readLines(argn, argc, argv, layers)
- * Sets a given pointer to an array of strings to
- * point at a dynamically allocated container T of
- * lines from the input file.
- * An input gives the option of reading the first line
- * as the number of lines in the file (T must be vector<string> in this case).
- * T should be a container of strings with push_back.
- * Exits with error if file not found
- */
-template<typename T>
-const T readLines(int argc, char **argv, int argn, bool firstLineCount) {
-	T lines;
-	if (argc > argn) {
-		ifstream inFile(argv[argn]);
-		string line;
-
-		if (firstLineCount) { //if first line gives number of lines
-			getline(inFile, line);
-			size_t lineCount = stoul(line); //convert first line to uint
-			lines.reserve(lineCount);
+ * Function name: searchDictionary(board, dictionary, trie, options, found, report)
+ * Searches a board for the words of a given dictionary with the
+ * algorithm and number of threads chosen in the options, adding the
+ * dictionary indices of the words found to a given vector in
+ * dictionary order. Trie mode on several threads balances the cells
+ * between them by work stealing (see workStealing.h).
+ * The trie must have been built from the dictionary if the mode uses one.
+ * Adds the allocations made inside the search kernels and the words
+ * rejected by the letter filter to a given report, and with --stats
+ * the counters of the kernels, each mode counting in the counting
+ * instantiation of its own kernels. Lockstep mode searches word by
+ * word like word mode on boards too large for it.
+ */
+template<size_t adjacentN>
+void searchDictionary(const searchBoard<adjacentN> &board, const vector<string_view> &dictionary, const dictionaryTrie &trie, const searchOptions &options, vector<uint32_t> &found, searchReport &report) {
+	//each thread searches its own share into its own results, merged in thread order
+	const cellTable<adjacentN> &table = board.table;
+	size_t threadCount = options.threadCount;
+	vector<size_t> threadAllocations(threadCount, 0);
+	vector<size_t> threadFiltered(threadCount, 0);
+	vector<searchStats> threadStats(threadCount);
+
+	if (options.mode == TRIE_MODE && threadCount > 1) {
+		//start a trie-guided search from every cell of the board, seeding each thread with a share of the cells to steal from
+		//the deques of each calling thread are reused by its later searches, through a reference for the workers to share
+		static thread_local stealingScheduler reused;
+		stealingScheduler &scheduler = reused;
+		scheduler.reset(threadCount, 1);
+		for (size_t threadN = 0; threadN < threadCount; threadN++) {
+			seedRange(scheduler, board.cellCount * threadN / threadCount, board.cellCount * (threadN + 1) / threadCount, threadN);
 		}
 
-		while (getline(inFile, line)) { //until reaches end of file
-			lines.push_back(line); //add line
+		vector< vector<bool> > threadFlags(threadCount);
+		vector<workerLoad> loads(threadCount);
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		runWorkers(threadCount, [&](size_t threadN) {
+			visitedSet visited(board.cellCount);
+			threadFlags[threadN].assign(dictionary.size(), false);
+
+			size_t before = allocationCount;
+			if (options.stats) searchCellsStealing<true>(table, trie, scheduler, threadN, visited, threadFlags[threadN], loads[threadN], &threadStats[threadN]);
+			else searchCellsStealing(table, trie, scheduler, threadN, visited, threadFlags[threadN], loads[threadN]);
+			threadAllocations[threadN] = allocationCount - before;
+		});
+		double elapsed = getElapsed(start);
+
+		for (size_t wordN = 0; wordN < dictionary.size(); wordN++) {
+			for (size_t threadN = 0; threadN < threadCount; threadN++) {
+				if (threadFlags[threadN][wordN]) {
+					found.push_back(wordN);
+					break;
+				}
+			}
+		}
+
+		if (options.stats) {
+			report.busyTimes.resize(threadCount, 0);
+			report.stealingTime += elapsed;
+			for (size_t threadN = 0; threadN < threadCount; threadN++) {
+				report.busyTimes[threadN] += loads[threadN].busyTime;
+				report.tasks += loads[threadN].tasks;
+				report.steals += loads[threadN].steals;
+			}
+		}
+	} else if (usesTrie(options.mode)) {
+		//start a trie-guided search from every cell of the honeycomb, partitioning the cells
+		vector< vector<bool> > threadFlags(threadCount);
+		runWorkers(threadCount, [&](size_t threadN) {
+			uint32_t begin = board.cellCount * threadN / threadCount;
+			uint32_t end = board.cellCount * (threadN + 1) / threadCount;
+			visitedSet visited(board.cellCount);
+			threadFlags[threadN].assign(dictionary.size(), false);
+
+			size_t before = allocationCount;
+			searchStats *stats = &threadStats[threadN];
+			if (options.mode == IMPLICIT_MODE) {
+				if (options.stats) searchImplicitCells<true>(board.implicit, trie, begin, end, visited, threadFlags[threadN], stats);
+				else searchImplicitCells(board.implicit, trie, begin, end, visited, threadFlags[threadN]);
+			} else {
+				if (options.stats) searchCells<true>(table, trie, begin, end, visited, threadFlags[threadN], stats);
+				else searchCells(table, trie, begin, end, visited, threadFlags[threadN]);
+			}
+			threadAllocations[threadN] = allocationCount - before;
+		});
+
+		for (size_t wordN = 0; wordN < dictionary.size(); wordN++) {
+			for (size_t threadN = 0; threadN < threadCount; threadN++) {
+				if (threadFlags[threadN][wordN]) {
+					found.push_back(wordN);
+					break;
+				}
+			}
 		}
+	} else {
+		//iterate through words in dictionary and search, partitioning the dictionary
+		size_t maxLength = 0;
+		for (string_view word : dictionary) maxLength = max(maxLength, word.length());
+		bool memoise = options.mode == ITERATIVE_MODE && is_sorted(dictionary.begin(), dictionary.end()); //consecutive words share prefixes
+		lockstepBoard lockstep;
+		if (options.mode == LOCKSTEP_MODE) buildLockstepBoard(table, lockstep);
 
-		inFile.close();
-	} else exit(1);
+		vector< vector<uint32_t> > threadFound(threadCount);
+		runWorkers(threadCount, [&](size_t threadN) {
+			size_t begin = dictionary.size() * threadN / threadCount;
+			size_t end = dictionary.size() * (threadN + 1) / threadCount;
+			visitedSet visited(table.getCellCount());
+			vector<searchFrame> stack(options.mode == ITERATIVE_MODE ? maxLength : 0);
+			searchMemo memo;
+			threadFound[threadN].reserve(end - begin);
 
-	return lines;
+			size_t allocations = 0;
+			size_t filtered = 0;
+			if (lockstep.usable) {
+				size_t before = allocationCount;
+				if (options.stats) filtered = searchLockstepWords<true>(table, lockstep, dictionary, begin, end, options.letterFilter, visited, threadFound[threadN], &threadStats[threadN]);
+				else filtered = searchLockstepWords(table, lockstep, dictionary, begin, end, options.letterFilter, visited, threadFound[threadN]);
+				allocations = allocationCount - before;
+				begin = end; //all searched
+			}
+			for (size_t wordN = begin; wordN < end; wordN++) {
+				if (options.letterFilter && !passesLetterFilter(table, dictionary[wordN])) {
+					filtered++;
+					continue;
+				}
+
+				size_t before = allocationCount;
+				searchStats *stats = &threadStats[threadN];
+				bool hit = options.mode == ANCHOR_MODE ? (options.stats ? searchWordAnchored<true>(table, dictionary[wordN], visited, stats)
+						: searchWordAnchored(table, dictionary[wordN], visited))
+					: memoise ? (options.stats ? searchWordMemo<true>(table, dictionary[wordN], visited, stack.data(), memo, stats)
+						: searchWordMemo(table, dictionary[wordN], visited, stack.data(), memo))
+					: options.mode == ITERATIVE_MODE ? (options.stats ? searchWordIterative<true>(table, dictionary[wordN], visited, stack.data(), stats)
+						: searchWordIterative(table, dictionary[wordN], visited, stack.data()))
+					: options.stats ? searchWordBySize<true>(table, dictionary[wordN], visited, stats)
+					: searchWordBySize(table, dictionary[wordN], visited);
+				allocations += allocationCount - before;
+
+				if (hit) threadFound[threadN].push_back(wordN);
+			}
+			threadAllocations[threadN] = allocations;
+			threadFiltered[threadN] = filtered;
+		});
+
+		for (size_t threadN = 0; threadN < threadCount; threadN++) {
+			found.insert(found.end(), threadFound[threadN].begin(), threadFound[threadN].end());
+		}
+	}
+
+	for (size_t threadN = 0; threadN < threadCount; threadN++) {
+		report.allocations += threadAllocations[threadN];
+		report.filtered += threadFiltered[threadN];
+		report.stats.add(threadStats[threadN]);
+	}
 }
 
 /*
- * Function name: getBucket(value)
- * Returns the position of a given capital letter amongst all
- * capital letters.
+ * Function name: searchCompiledDictionary(board, dictionary, options, found, report)
+ * Same as searchDictionary() in trie mode with a compiled dictionary
+ * in place of the trie, adding the ranks of the words found in sorted
+ * order. The board must have a cell table.
  */
-const inline size_t getBucket(const char value) {
-	return value - 'A';
+template<size_t adjacentN>
+void searchCompiledDictionary(const searchBoard<adjacentN> &board, const compiledDictionary &dictionary, const searchOptions &options, vector<uint32_t> &found, searchReport &report) {
+	size_t threadCount = options.threadCount;
+	vector<size_t> threadAllocations(threadCount, 0);
+	vector<searchStats> threadStats(threadCount);
+	vector< vector<bool> > threadFlags(threadCount);
+	runWorkers(threadCount, [&](size_t threadN) {
+		uint32_t begin = board.cellCount * threadN / threadCount;
+		uint32_t end = board.cellCount * (threadN + 1) / threadCount;
+		visitedSet visited(board.cellCount);
+		threadFlags[threadN].assign(dictionary.wordCount, false);
+
+		size_t before = allocationCount;
+		if (options.stats) searchCompiledCells<true>(board.table, dictionary, begin, end, visited, threadFlags[threadN], &threadStats[threadN]);
+		else searchCompiledCells(board.table, dictionary, begin, end, visited, threadFlags[threadN]);
+		threadAllocations[threadN] = allocationCount - before;
+	});
+
+	for (size_t rank = 0; rank < dictionary.wordCount; rank++) {
+		for (size_t threadN = 0; threadN < threadCount; threadN++) {
+			if (threadFlags[threadN][rank]) {
+				found.push_back(rank);
+				break;
+			}
+		}
+	}
+
+	for (size_t threadN = 0; threadN < threadCount; threadN++) {
+		report.allocations += threadAllocations[threadN];
+		report.stats.add(threadStats[threadN]);
+	}
 }
 
 /*
- * Function name: getBucket(value)
- * Returns whether the node at the given coordinates is a corner node
+ * Function name: countDictionary(board, dictionary, options, found, counts, report)
+ * Counts the simple paths spelling every word of a given dictionary on
+ * a board (see pathCount.h), setting a given vector to the counts by
+ * dictionary index and adding the indices of the words with any path
+ * to another in dictionary order. Rather than the dictionary, the start
+ * cells of all of its words are split evenly across the threads, so a
+ * word with many start cells may be counted by several of them, each
+ * adding up the paths from its own share. The board must have a cell table.
  */
-const inline bool isCorner(const size_t layerN, const size_t charN) {
-	if (layerN == 0) return true;
-	return (charN % layerN == 0);
+template<size_t adjacentN>
+void countDictionary(const searchBoard<adjacentN> &board, const vector<string_view> &dictionary, const searchOptions &options, vector<uint32_t> &found, vector<uint64_t> &counts, searchReport &report) {
+	//position of the first start cell of every word in the sequence of the start cells of all of them
+	const cellTable<adjacentN> &table = board.table;
+	vector<size_t> startOffsets(dictionary.size() + 1, 0);
+	size_t maxLength = 0; //of the words counted
+	for (size_t wordN = 0; wordN < dictionary.size(); wordN++) {
+		string_view word = dictionary[wordN];
+		bool possible = isWord(word) && (!options.letterFilter || passesLetterFilter(table, word));
+		if (!possible && options.letterFilter) report.filtered++;
+		if (possible) maxLength = max(maxLength, word.length());
+		startOffsets[wordN + 1] = startOffsets[wordN] + (possible ? table.getBucketSize(getBucket(word[0])) : 0);
+	}
+
+	size_t threadCount = options.threadCount;
+	size_t startCount = startOffsets.back();
+	vector< vector< pair<uint32_t, uint64_t> > > threadCounts(threadCount); //words with paths from the share of each thread
+	vector<size_t> threadAllocations(threadCount, 0);
+	runWorkers(threadCount, [&](size_t threadN) {
+		size_t begin = startCount * threadN / threadCount;
+		size_t end = startCount * (threadN + 1) / threadCount;
+		pathCounter counter;
+		preparePathCounter(table, maxLength, counter);
+		size_t wordN = upper_bound(startOffsets.begin(), startOffsets.end(), begin) - startOffsets.begin() - 1;
+		size_t endN = lower_bound(startOffsets.begin(), startOffsets.end(), end) - startOffsets.begin();
+		threadCounts[threadN].reserve(endN - wordN); //words with start cells in the share
+
+		size_t before = allocationCount;
+		for (; wordN < dictionary.size() && startOffsets[wordN] < end; wordN++) {
+			size_t first = max(begin, startOffsets[wordN]) - startOffsets[wordN];
+			size_t last = min(end, startOffsets[wordN + 1]) - startOffsets[wordN];
+			if (first == last) continue;
+
+			countWalks(table, dictionary[wordN], counter);
+			uint64_t paths = countPaths(table, dictionary[wordN], first, last, counter);
+			if (paths != 0) threadCounts[threadN].push_back({ (uint32_t)wordN, paths });
+		}
+		threadAllocations[threadN] = allocationCount - before;
+	});
+
+	counts.assign(dictionary.size(), 0);
+	for (size_t threadN = 0; threadN < threadCount; threadN++) {
+		for (const pair<uint32_t, uint64_t> &wordCount : threadCounts[threadN]) {
+			if (counts[wordCount.first] == 0) found.push_back(wordCount.first); //threads come in dictionary order
+			counts[wordCount.first] = addCounts(counts[wordCount.first], wordCount.second);
+		}
+		report.allocations += threadAllocations[threadN];
+	}
+	report.stats.starts += startCount;
 }
 
 /*
- * Function name: populateLinkedNodeArray(layers, linkedNodeArray, positionNodeArray)
- * Fills an array of linked lists of polygon nodes using a given
- * polygon of characters. Iterates through the layers from lowest
- * to greatest and links nodes during collisions.
- * WARNING: does not set neighbors!
- * The nodes are dynamically allocated.
+ * Function name: printReport(report, options)
+ * Prints the benchmark output of a search to standard error
+ * as a single line of key=value pairs, ending with the peak
+ * resident set size of the process so far
  */
-void populateLinkedNodeArray(const vector<string> &layers, linkedPolygonNode<SIDES> ** linkedNodeArray, vector< vector< linkedPolygonNode<SIDES> * > > &positionNodeArray) {
-	for (size_t layerN = 0; layerN < layers.size(); layerN++) {
-		string layer = layers[layerN];
+void printReport(const searchReport &report, const searchOptions &options) {
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
 
-		vector<linkedPolygonNode<SIDES> *> layerVector; //create vector of nodes for current layer
-		positionNodeArray.push_back(layerVector);
+	cerr << "mode=" << MODE_NAMES[options.mode]
+		<< " words=" << report.words
+		<< " threads=" << options.threadCount
+		<< " cells=" << report.cells
+		<< " found=" << report.found
+		<< " build_ms=" << report.buildTime
+		<< " search_ms=" << report.searchTime
+		<< " output_ms=" << report.outputTime
+		<< " words_per_sec=" << (report.searchTime == 0 ? 0.0 : report.words / report.searchTime * 1000)
+		<< " allocs_per_query=" << (report.words == 0 ? 0.0 : (double)report.allocations / report.words)
+		<< " filtered=" << report.filtered
+		<< " peak_rss_kb=" << usage.ru_maxrss
+		<< endl;
+}
 
-		for (size_t charN = 0; charN < layer.length(); charN++) {
-			char value = layer[charN];
-			linkedPolygonNode<SIDES> *newNode = new linkedPolygonNode<SIDES>;
+/*
+ * Function name: printStats(report)
+ * Prints the --stats output of a search to standard error as a
+ * single line of key=value pairs: the time of each phase, then the
+ * counters of the search kernels, per word searched where that
+ * makes sense (in trie modes a start is a cell, not a word), and for
+ * work-stealing searches the tasks run and stolen and the share of the
+ * search each thread spent running tasks
+ */
+void printStats(const searchReport &report) {
+	const searchStats &stats = report.stats;
+	double queries = report.words - report.filtered;
 
-			//set values and coordinates
-			newNode->value = value;
-			newNode->layerN = layerN;
-			newNode->charN = charN;
+	cerr << "stats read_ms=" << report.readTime
+		<< " trie_ms=" << report.trieTime
+		<< " populate_ms=" << report.populateTime
+		<< " neighbors_ms=" << report.neighborTime
+		<< " letters_ms=" << report.letterTime
+		<< " search_ms=" << report.searchTime
+		<< " sort_ms=" << report.sortTime
+		<< " write_ms=" << report.writeTime
+		<< " calls=" << stats.calls
+		<< " visits=" << stats.visits
+		<< " pruned=" << stats.pruned
+		<< " avg_depth=" << (stats.calls == 0 ? 0.0 : (double)stats.depthSum / stats.calls)
+		<< " starts=" << stats.starts
+		<< " starts_per_word=" << (queries == 0 ? 0.0 : stats.starts / queries)
+		<< " hit_rate=" << (report.words == 0 ? 0.0 : (double)report.found / report.words);
 
-			//set node in position array of nodes
-			(positionNodeArray[layerN]).push_back(newNode);
+	if (!report.busyTimes.empty()) {
+		cerr << " tasks=" << report.tasks << " steals=" << report.steals << " utilisation=";
+		for (size_t threadN = 0; threadN < report.busyTimes.size(); threadN++) {
+			cerr << (threadN == 0 ? "" : ",") << (report.stealingTime == 0 ? 0.0 : report.busyTimes[threadN] / report.stealingTime);
+		}
+	}
+	cerr << endl;
+}
 
-			//set node in array of linked lists
-			size_t bucket = getBucket(value);
+/*
+ * Function name: sortFound(dictionary, found, threadCount)
+ * Sorts the dictionary indices of the words found by word, unless
+ * the dictionary is already sorted, in which case the indices (in
+ * dictionary order) already are. Otherwise each thread sorts a
+ * contiguous run of the indices and the runs are merged pairwise,
+ * the merges of each round running in parallel.
+ */
+void sortFound(const vector<string_view> &dictionary, const bool dictionarySorted, vector<uint32_t> &found, const size_t threadCount) {
+	if (dictionarySorted || found.size() < 2) return;
 
-			if (linkedNodeArray[bucket] == NULL) linkedNodeArray[bucket] = newNode; //set first node to new node
-			else {
-				linkedPolygonNode<SIDES> *last = linkedNodeArray[bucket]->getLastNode();
-				last->nextPtr = newNode; //set end of linked list to new node
-			}
+	auto byWord = [&dictionary](uint32_t a, uint32_t b) { return dictionary[a] < dictionary[b]; };
+	size_t runCount = min(threadCount, found.size());
+	vector<size_t> bounds(runCount + 1);
+	for (size_t runN = 0; runN <= runCount; runN++) {
+		bounds[runN] = found.size() * runN / runCount;
+	}
+
+	runWorkers(runCount, [&](size_t runN) {
+		sort(found.begin() + bounds[runN], found.begin() + bounds[runN + 1], byWord);
+	});
+
+	for (size_t width = 1; width < runCount; width *= 2) {
+		size_t mergeCount = (runCount - width + 2 * width - 1) / (2 * width); //pairs of runs in this round
+		runWorkers(mergeCount, [&](size_t mergeN) {
+			size_t first = 2 * width * mergeN;
+			inplace_merge(found.begin() + bounds[first], found.begin() + bounds[first + width],
+				found.begin() + bounds[min(first + 2 * width, runCount)], byWord);
+		});
+	}
+}
+
+/*
+ * Function name: writeFound(dictionary, found, writer)
+ * Writes the words with the given dictionary indices, one per line
+ */
+void writeFound(const vector<string_view> &dictionary, const vector<uint32_t> &found, bufferedWriter &writer) {
+	for (uint32_t wordN : found) {
+		writer.writeLine(dictionary[wordN]);
+	}
+}
+
+/*
+ * Function name: writeCompiledFound(dictionary, found, writer)
+ * Writes the words with the given ranks in a compiled dictionary, one per line
+ */
+void writeCompiledFound(const compiledDictionary &dictionary, const vector<uint32_t> &found, bufferedWriter &writer) {
+	string word;
+	word.reserve(dictionary.maxLength);
+	for (uint32_t rank : found) {
+		dictionary.getWord(rank, word);
+		writer.writeLine(word);
+	}
+}
+
+/*
+ * Function name: writeCounts(dictionary, found, counts, writer)
+ * Writes the words with the given dictionary indices, one per line,
+ * each followed by its count in the given counts by dictionary index
+ */
+void writeCounts(const vector<string_view> &dictionary, const vector<uint32_t> &found, const vector<uint64_t> &counts, bufferedWriter &writer) {
+	string line;
+	for (uint32_t wordN : found) {
+		line = dictionary[wordN];
+		line += " " + to_string(counts[wordN]);
+		writer.writeLine(line);
+	}
+}
+
+/*
+ * Function name: writePaths<grid>(table, dictionary, compiled, found, writer)
+ * Writes the words with the given dictionary indices (or ranks in the
+ * compiled dictionary, if open), one per line, each followed by the
+ * coordinates of the cells of a path spelling it on a given cell table
+ * of a given topology, as "(layerN, charN)" (row and column on grids).
+ * The paths are recorded by the instantiation of searchWord() that
+ * keeps them, run again on only the words found.
+ */
+template<typename grid>
+void writePaths(const cellTable<grid::adjacentN> &table, const vector<string_view> &dictionary, const compiledDictionary &compiled, const vector<uint32_t> &found, bufferedWriter &writer) {
+	visitedSet visited(table.getCellCount());
+	vector<uint32_t> path;
+	string word, line;
+	for (uint32_t wordN : found) {
+		if (compiled.isOpen()) compiled.getWord(wordN, word);
+		else word = dictionary[wordN];
+
+		path.resize(word.length());
+		searchWord<false, true>(table, word, visited, NULL, path.data()); //found, so a path exists
+
+		line = word;
+		for (uint32_t cell : path) {
+			cellCoordinates coordinates = grid::getCoordinates(table, cell);
+			line += " (" + to_string(coordinates.layerN) + ", " + to_string(coordinates.charN) + ")";
 		}
+		writer.writeLine(line);
 	}
 }
 
 /*
- * Function name: setNeighbors(positionNodeArray)
- * Sets the adjacent node pointers of all nodes in the position node array
- * Values for neighbors' coordinates follow from mathematical derivation
- * Specific to SIDES = 6
+ * Function name: readChunk(input, lines)
+ * Reads up to lines.size() lines from a given stream into a given
+ * vector of strings, dropping any carriage return before the line
+ * ending. The strings are reused, so steady-state reads of lines no
+ * longer than before do not allocate.
+ * Returns the number of lines read, less than requested at the end
+ * of the stream.
  */
-void setNeighbors(vector< vector< linkedPolygonNode<SIDES> * > > &positionNodeArray) {
-	size_t layerCount = positionNodeArray.size();
-	for (size_t layerN = 0; layerN < layerCount; layerN++) {
-		size_t charCount = positionNodeArray[layerN].size();
-		for (size_t charN = 0; charN < charCount; charN++) {
-			linkedPolygonNode<SIDES> * current = positionNodeArray[layerN][charN];
+size_t readChunk(istream &input, vector<string> &lines) {
+	size_t lineN = 0;
+	while (lineN < lines.size() && getline(input, lines[lineN])) {
+		if (!lines[lineN].empty() && lines[lineN].back() == '\r') lines[lineN].pop_back();
+		lineN++;
+	}
+	return lineN;
+}
 
-			if (layerN > 0) {
-				//inside neighbor (if corner) or inside right neighbor (otherwise)
-				if (charN < charCount - 1) current->adjacentList[0] = positionNodeArray[layerN - 1][(layerN - 1) * (charN / layerN) + (charN % layerN)];
-				else current->adjacentList[0] = positionNodeArray[layerN - 1][0];
-			
-				//inside left neighbor (only exists if not corner)
-				if (!isCorner(layerN, charN)) {
-					current->adjacentList[5] = positionNodeArray[layerN - 1][(layerN - 1) * (charN / layerN) + (charN % layerN) - 1];
-				}
+/*
+ * Function name: readBlock(input, count, lines)
+ * Reads a given number of lines from a given stream into a vector
+ * of strings (see readChunk()).
+ * Returns false if the stream ends first.
+ */
+bool readBlock(istream &input, const size_t count, vector<string> &lines) {
+	lines.resize(count);
+	return readChunk(input, lines) == count;
+}
+
+/*
+ * Function name: parseCellChange(line, table, change)
+ * Parses a line "layerN charN letter" naming a cell of a given table
+ * and its new letter into a given change.
+ * Returns false if the line is malformed or the cell is not on the board.
+ */
+bool parseCellChange(const string &line, const cellTable<SIDES> &table, cellChange &change) {
+	size_t first = line.find(' ');
+	size_t second = first == string::npos ? string::npos : line.find(' ', first + 1);
+	if (second == string::npos || second + 2 != line.length()) return false;
+
+	size_t layerN, charN;
+	if (!parseCount(line.substr(0, first).c_str(), layerN) || !parseCount(line.substr(first + 1, second - first - 1).c_str(), charN)) return false;
+	if (layerN >= table.getLayerCount() || charN >= getLayerSize(layerN)) return false;
+
+	change.cell = getLayerStart(layerN) + charN;
+	change.value = line[second + 1];
+	return true;
+}
+
+/*
+ * Struct holding one request of runServer() as read, and for BOARD
+ * built, by its reader thread. Requests are recycled once answered,
+ * so their strings are reused.
+ */
+struct serverRequest
+{
+	string name; //BOARD, WORDS or SET
+	string error; //if set, the request is answered with "ERROR error"
+	vector<string> lines;
+	vector<string_view> views;
+	string storage; //folded words of WORDS
+	searchBoard<> *board = NULL; //BOARD: the board built from the lines
+	searchReport report;
+};
+
+/*
+ * Function name: readRequest(command, request, freeBoards, options)
+ * Reads the lines of a request with a given command line from standard
+ * input into a given request, checks them and prepares them for its
+ * search: folds the words of WORDS and builds the board of BOARD on one
+ * taken from the given queue of free boards, with the neighbors of the
+ * given cache. Sets the error of the request if it is malformed.
+ * Returns false if the input ends before the lines of the request.
+ */
+bool readRequest(const string &command, serverRequest &request, boundedQueue<searchBoard<> *> &freeBoards, neighborCache &cache, const searchOptions &options) {
+	request.error.clear();
+	request.board = NULL;
+	request.report = searchReport();
+
+	size_t space = command.find(' ');
+	request.name = command.substr(0, space);
+	size_t count = 0;
+	if ((request.name != "BOARD" && request.name != "WORDS" && request.name != "SET") || space == string::npos || !parseCount(command.c_str() + space + 1, count)) {
+		request.error = "unknown command";
+		return true;
+	}
+
+	if (!readBlock(cin, count, request.lines)) {
+		request.error = "expected " + to_string(count) + " lines";
+		return false;
+	}
+	request.views.assign(request.lines.begin(), request.lines.end());
+	if (request.name == "WORDS") normaliseDictionary(request.views, request.storage);
+
+	if (request.name == "BOARD") {
+		if (!isHoneycomb(request.views)) {
+			request.error = "layer sizes do not form a honeycomb";
+			return true;
+		}
+
+		freeBoards.pop(request.board);
+		chrono::steady_clock::time_point buildStart = chrono::steady_clock::now();
+		buildBoard<hexGrid>(request.views, options, *request.board, request.report, &cache);
+		request.report.buildTime = getElapsed(buildStart);
+	}
+	return true;
+}
+
+/*
+ * Function name: runServer(dictionary, trie, cache, options)
+ * Long-running mode that keeps the dictionary and its trie loaded
+ * and answers requests read from standard input, one per command:
+ *   BOARD n  followed by the n layers of a honeycomb: replaces the
+ *            board and searches it for every dictionary word
+ *   WORDS n  followed by n words: searches the current board for them
+ *   SET n    followed by n lines "layerN charN letter": changes the
+ *            letters of cells of the current board (see updateCells())
+ *   QUIT     ends the session (as does the end of the input)
+ * Every request is answered with "OK count" followed by the sorted
+ * words found, or with "ERROR message". SET is answered with the words
+ * of the dictionary that are now found, each as "+word", followed by
+ * those that no longer are, each as "-word".
+ * The requests go through a two-stage pipeline: a reader thread reads
+ * and parses the next requests, building the boards of BOARD requests,
+ * while the calling thread searches the current one and writes its
+ * reply. The two are connected by bounded queues of recycled requests
+ * and of boards, whose arenas are reused, and the reader keeps the
+ * neighbors of the board sizes seen in a given cache, so steady-state
+ * requests only pay for copying the letters in and searching, and the
+ * building overlaps with the search of the requests before.
+ */
+int runServer(const vector<string_view> &dictionary, const dictionaryTrie &trie, neighborCache &cache, const searchOptions &options) {
+	//the reader can be this many requests ahead, each with a board besides the current one
+	const size_t requestCount = 4;
+	vector<serverRequest> requests(requestCount);
+	vector< searchBoard<> > boards(requestCount + 1);
+	boundedQueue<serverRequest *> freeRequests(requestCount), readRequests(requestCount);
+	boundedQueue<searchBoard<> *> freeBoards(requestCount + 1);
+	for (serverRequest &request : requests) freeRequests.push(&request);
+	for (searchBoard<> &board : boards) freeBoards.push(&board);
+
+	thread reader([&]() {
+		serverRequest *request;
+		string command;
+		while (freeRequests.pop(request)) {
+			bool more = false;
+			while ((more = (bool)getline(cin, command))) {
+				if (!command.empty() && command.back() == '\r') command.pop_back();
+				if (!command.empty()) break;
+			}
+			if (!more || command == "QUIT") break;
+
+			more = readRequest(command, *request, freeBoards, cache, options);
+			readRequests.push(request);
+			if (!more) break;
+		}
+		readRequests.close();
+	});
 
-				//left neighbor
-				if (charN > 0) current->adjacentList[1] = positionNodeArray[layerN][charN - 1];
-				else current->adjacentList[1] = positionNodeArray[layerN][charCount - 1];
+	searchBoard<> *current = NULL; //board of the last BOARD request
+	vector<bool> foundFlags; //dictionary words found on the current board
+	dictionaryTrie updateTrie; //trie for SET in modes without one, built on first use
+	vector<cellChange> changes;
+	vector<uint32_t> added, removed;
 
-				//right neighbor
-				if (charN < charCount - 1) current->adjacentList[2] = positionNodeArray[layerN][charN + 1];
-				else current->adjacentList[2] = positionNodeArray[layerN][0];
+	vector<uint32_t> found;
+	bool dictionarySorted = is_sorted(dictionary.begin(), dictionary.end());
+	bufferedWriter writer(stdout);
 
-				if (layerN < layerCount - 1) {
-					//outside left neighbor (only exists if corner)
-					if (isCorner(layerN, charN)) {
-						if (charN > 0) current->adjacentList[5] = positionNodeArray[layerN + 1][(layerN + 1) * (charN / layerN) - 1];
-						else current->adjacentList[5] = positionNodeArray[layerN + 1][charCount + SIDES - 1]; //last of next layer
-					}
+	serverRequest *request;
+	while (readRequests.pop(request)) {
+		const string &name = request->name;
+		const vector<string> &lines = request->lines;
+		const vector<string_view> &views = request->views;
+		searchReport &report = request->report;
+		if (!request->error.empty()) {
+			writer.writeLine("ERROR " + request->error);
+			writer.flush();
+			freeRequests.push(request);
+			continue;
+		}
+
+		found.clear();
+		string error;
+		if (name == "BOARD") {
+			if (current != NULL) freeBoards.push(current);
+			current = request->board;
+
+			chrono::steady_clock::time_point searchStart = chrono::steady_clock::now();
+			searchDictionary(*current, dictionary, trie, options, found, report);
+			report.searchTime = getElapsed(searchStart);
 
-					//outside middle neighbor (if corner) or outside left (otherwise)
-					current->adjacentList[3] = positionNodeArray[layerN + 1][(layerN + 1) * (charN / layerN) + (charN % layerN)];
+			chrono::steady_clock::time_point sortStart = chrono::steady_clock::now();
+			sortFound(dictionary, dictionarySorted, found, options.threadCount);
+			report.sortTime = getElapsed(sortStart);
+			report.words = dictionary.size();
+
+			writer.writeLine("OK " + to_string(found.size()));
+			writeFound(dictionary, found, writer);
+
+			foundFlags.assign(dictionary.size(), false);
+			for (uint32_t wordN : found) foundFlags[wordN] = true;
+		} else if (current == NULL) {
+			error = "no board loaded";
+		} else if (name == "SET" && options.mode == IMPLICIT_MODE) {
+			error = "SET needs a cell table (not --mode implicit)";
+		} else if (name == "SET") {
+			changes.clear();
+			for (const string &line : lines) {
+				cellChange change;
+				if (!parseCellChange(line, current->table, change)) break;
+				changes.push_back(change);
+			}
 
-					//outside right neighbor
-					current->adjacentList[4] = positionNodeArray[layerN + 1][(layerN + 1) * (charN / layerN) + (charN % layerN) + 1];
+			if (changes.size() != lines.size()) {
+				error = "expected \"layerN charN letter\" lines naming cells of the board";
+			} else {
+				chrono::steady_clock::time_point trieStart = chrono::steady_clock::now();
+				if (!usesTrie(options.mode) && updateTrie.nodes.empty()) buildTrie(dictionary, updateTrie);
+				report.trieTime = getElapsed(trieStart);
+
+				chrono::steady_clock::time_point searchStart = chrono::steady_clock::now();
+				updateCells(current->table, dictionary, usesTrie(options.mode) ? trie : updateTrie, changes, foundFlags, added, removed);
+				report.searchTime = getElapsed(searchStart);
+
+				chrono::steady_clock::time_point sortStart = chrono::steady_clock::now();
+				sortFound(dictionary, dictionarySorted, added, options.threadCount);
+				sortFound(dictionary, dictionarySorted, removed, options.threadCount);
+				report.sortTime = getElapsed(sortStart);
+
+				writer.writeLine("OK " + to_string(added.size() + removed.size()));
+				for (uint32_t wordN : added) {
+					writer.write("+");
+					writer.writeLine(dictionary[wordN]);
 				}
-			} else if (layerCount > 1) {
-				//manually set for central node
-				for (size_t neighborN = 0; neighborN < SIDES; neighborN++) {
-					current->adjacentList[neighborN] = positionNodeArray[1][neighborN];
+				for (uint32_t wordN : removed) {
+					writer.write("-");
+					writer.writeLine(dictionary[wordN]);
 				}
+				report.words = dictionary.size();
+
+				//the words of the reply, for the report
+				found.assign(added.begin(), added.end());
+				found.insert(found.end(), removed.begin(), removed.end());
 			}
+		} else {
+			chrono::steady_clock::time_point trieStart = chrono::steady_clock::now();
+			dictionaryTrie batchTrie;
+			if (usesTrie(options.mode)) buildTrie(views, batchTrie);
+			report.trieTime = getElapsed(trieStart);
+
+			chrono::steady_clock::time_point searchStart = chrono::steady_clock::now();
+			searchDictionary(*current, views, batchTrie, options, found, report);
+			report.searchTime = getElapsed(searchStart);
+
+			chrono::steady_clock::time_point sortStart = chrono::steady_clock::now();
+			sortFound(views, is_sorted(views.begin(), views.end()), found, options.threadCount);
+			report.sortTime = getElapsed(sortStart);
+			report.words = views.size();
+
+			writer.writeLine("OK " + to_string(found.size()));
+			writeFound(views, found, writer);
+		}
+		if (!error.empty()) writer.writeLine("ERROR " + error);
+		writer.flush();
+
+		if (error.empty()) {
+			report.cells = current->cellCount;
+			report.found = found.size();
+			if (options.benchmark) printReport(report, options);
+			if (options.stats) printStats(report);
 		}
+		freeRequests.push(request);
 	}
+
+	reader.join();
+	return 0;
 }
 
 /*
- * Function name: searchNodes(linkedNodeArray, word)
- * Searches an array of linked lists of polygon nodes for a given word
- * Iterates over all nodes with the first letter and then searches
- * over neighbors for subsequent letters via recursive depth-first search
+ * Struct holding one board of a batch on its way through the stages
+ * of runBatch(), along with the words found on it. Jobs are recycled
+ * once written, so their board arenas and vectors are reused.
+ */
+template<size_t adjacentN>
+struct batchJob
+{
+	size_t boardN = 0; //position of the board in the file, counting from 0
+	vector<string_view> layers;
+	searchBoard<adjacentN> board;
+	vector<uint32_t> found;
+};
+
+/*
+ * Function name: runBatch<grid>(path, lines, dictionary, trie, compiled, cache, options, report, error)
+ * Searches every one of the boards of a given topology in the lines
+ * of a given file (see readBoard()) for the words of the dictionary,
+ * sharing its trie (or its compiled form, if open) between them. The
+ * boards go through a pipeline of stages connected by bounded queues,
+ * so that parsing, building and writing the results overlap with the
+ * searches: a thread parses the boards, a thread builds them (with the
+ * neighbors of the board sizes seen kept in a given cache), the
+ * threads of the options search them (each board on a single thread)
+ * and the calling thread writes the results in board order, each board
+ * as "BOARD n count" (n counting from 1) followed by the sorted words
+ * found. At most a fixed pool of jobs is in flight, which bounds the
+ * memory used however many boards there are.
+ * Adds the measurements of the searches to a given report, counting
+ * one query per word and board.
+ * Returns false and sets error if a board is malformed, in which case
+ * the results of the boards before it have been written.
  */
-bool searchNodes(linkedPolygonNode<SIDES> ** linkedNodeArray, const string word, linkedPolygonNode<SIDES> * current) {
-	if (current == NULL) return false; //dead-end
-	if (word.length() == 0) return true; //found!
+template<typename grid>
+bool runBatch(const char *path, const vector<string_view> &lines, const vector<string_view> &dictionary, const dictionaryTrie &trie, const compiledDictionary &compiled, neighborCache &cache, const searchOptions &options, searchReport &report, string &error) {
+	bool dictionarySorted = is_sorted(dictionary.begin(), dictionary.end());
+	searchOptions boardOptions = options;
+	boardOptions.threadCount = 1;
 
-	char first = word[0];
-	current->visited = true;
+	//enough jobs for every searching thread to have one waiting, and one for each other stage
+	size_t jobCount = 2 * options.threadCount + 3;
+	vector< batchJob<grid::adjacentN> > jobs(jobCount);
+	boundedQueue<batchJob<grid::adjacentN> *> freeJobs(jobCount), parsed(jobCount), built(jobCount), searched(jobCount);
+	for (batchJob<grid::adjacentN> &job : jobs) freeJobs.push(&job);
 
-	for (size_t neighborN = 0; neighborN < SIDES; neighborN++) { //iterate over neighbors
-		linkedPolygonNode<SIDES> * neighbor = (current->adjacentList)[neighborN];
+	searchReport buildReport;
+	vector<searchReport> threadReports(options.threadCount);
+	size_t boardCount = 0;
 
-		if (neighbor != NULL && neighbor->visited == false && neighbor->value == first) {
-			if (searchNodes(linkedNodeArray, word.substr(1), neighbor)) {
-				current->visited = false;
-				return true; //depth-first recursion
+	thread parser([&]() {
+		size_t lineN = 0;
+		batchJob<grid::adjacentN> *job;
+		while (freeJobs.pop(job) && readBoard<grid>(path, lines, lineN, boardCount + 1, job->layers, error)) {
+			job->boardN = boardCount++;
+			parsed.push(job);
+		}
+		parsed.close();
+	});
+
+	thread builder([&]() {
+		batchJob<grid::adjacentN> *job;
+		while (parsed.pop(job)) {
+			buildBoard<grid>(job->layers, boardOptions, job->board, buildReport, &cache);
+			built.push(job);
+		}
+		built.close();
+	});
+
+	thread searchers([&]() {
+		runWorkers(options.threadCount, [&](size_t threadN) {
+			batchJob<grid::adjacentN> *job;
+			while (built.pop(job)) {
+				job->found.clear();
+				if (compiled.isOpen()) {
+					searchCompiledDictionary(job->board, compiled, boardOptions, job->found, threadReports[threadN]);
+				} else {
+					searchDictionary(job->board, dictionary, trie, boardOptions, job->found, threadReports[threadN]);
+					sortFound(dictionary, dictionarySorted, job->found, 1);
+				}
+				threadReports[threadN].cells += job->board.cellCount;
+				searched.push(job);
 			}
+		});
+		searched.close();
+	});
+
+	//the boards in flight are the jobCount after the next one to write, so each has its own slot
+	vector<batchJob<grid::adjacentN> *> pending(jobCount, NULL);
+	size_t nextBoard = 0;
+	bufferedWriter writer(stdout);
+	batchJob<grid::adjacentN> *job;
+	while (searched.pop(job)) {
+		pending[job->boardN % jobCount] = job;
+		while ((job = pending[nextBoard % jobCount]) != NULL) {
+			chrono::steady_clock::time_point writeStart = chrono::steady_clock::now();
+			writer.writeLine("BOARD " + to_string(nextBoard + 1) + " " + to_string(job->found.size()));
+			if (compiled.isOpen()) writeCompiledFound(compiled, job->found, writer);
+			else writeFound(dictionary, job->found, writer);
+			report.writeTime += getElapsed(writeStart);
+
+			report.found += job->found.size();
+			pending[nextBoard % jobCount] = NULL;
+			nextBoard++;
+			freeJobs.push(job);
+		}
+	}
+	chrono::steady_clock::time_point flushStart = chrono::steady_clock::now();
+	writer.flush();
+	report.writeTime += getElapsed(flushStart);
+
+	parser.join();
+	builder.join();
+	searchers.join();
+
+	threadReports.push_back(buildReport);
+	for (const searchReport &threadReport : threadReports) {
+		report.cells += threadReport.cells;
+		report.allocations += threadReport.allocations;
+		report.filtered += threadReport.filtered;
+		report.populateTime += threadReport.populateTime;
+		report.neighborTime += threadReport.neighborTime;
+		report.letterTime += threadReport.letterTime;
+		report.stats.add(threadReport.stats);
+	}
+	report.words += (compiled.isOpen() ? compiled.wordCount : dictionary.size()) * boardCount;
+	return error.empty();
+}
+
+/*
+ * Function name: runStream(board, dictionaryPath, options, report, error)
+ * Searches a board for the words of a dictionary read in chunks of
+ * options.chunkSize words, writing the words found in a chunk as soon
+ * as it has been searched, so that memory is bounded by the chunk size
+ * rather than by the dictionary size. The words are written in
+ * dictionary order, which is only sorted if the dictionary is. The
+ * last word written is kept, so that a word repeated across the end of
+ * a chunk is written once: repeated words are all dropped from sorted
+ * dictionaries, and from others within a chunk.
+ * Returns false and sets error if the dictionary cannot be read.
+ */
+template<size_t adjacentN>
+bool runStream(const searchBoard<adjacentN> &board, const char *dictionaryPath, const searchOptions &options, searchReport &report, string &error) {
+	ifstream input(dictionaryPath);
+	if (!input) {
+		error = string(dictionaryPath) + ": " + strerror(errno);
+		return false;
+	}
+
+	vector<string> lines(options.chunkSize);
+	vector<string_view> chunk;
+	string storage; //folded words of the current chunk
+	vector<uint32_t> found;
+	string lastWord; //last word written, folded
+	dictionaryTrie trie;
+	bufferedWriter writer(stdout);
+
+	while (true) {
+		chrono::steady_clock::time_point readStart = chrono::steady_clock::now();
+		size_t count = readChunk(input, lines);
+		report.readTime += getElapsed(readStart);
+		if (count == 0) break;
+
+		chrono::steady_clock::time_point trieStart = chrono::steady_clock::now();
+		chunk.assign(lines.begin(), lines.begin() + count);
+		normaliseDictionary(chunk, storage);
+		if (usesTrie(options.mode)) buildTrie(chunk, trie);
+		report.trieTime += getElapsed(trieStart);
+
+		found.clear();
+		searchDictionary(board, chunk, trie, options, found, report);
+
+		chrono::steady_clock::time_point writeStart = chrono::steady_clock::now();
+		for (uint32_t wordN : found) {
+			if (chunk[wordN] == lastWord) continue; //written at the end of the previous chunk
+			writer.writeLine(chunk[wordN]);
+			report.found++;
 		}
+		if (!found.empty()) lastWord = chunk[found.back()];
+		writer.flush();
+		report.writeTime += getElapsed(writeStart);
+
+		report.words += count;
 	}
 
-	//reset and back-track
-	current->visited = false;
+	return true;
+}
+
+/*
+ * Function name: storeNeighbors(program, options, cache)
+ * Saves a given cache to the neighbor cache file of the options, if
+ * there is one and tables were added to the cache, printing why to
+ * standard error if it cannot.
+ * Returns false if the file could not be written.
+ */
+bool storeNeighbors(const char *program, const searchOptions &options, const neighborCache &cache) {
+	string error;
+	if (options.neighborsPath == NULL || !cache.changed || saveNeighborCache(options.neighborsPath, cache, error)) return true;
+
+	cerr << program << ": " << error << endl;
 	return false;
 }
 
 /*
- * Function name: main(argc, argv)
- * Main function that searches for given words in a given honeycomb
- * Example usage: "./hexagonalSearch honeycomb.txt dictionary.txt"
+ * Function name: searchGrid<grid>(program, options)
+ * Reads the boards of a given topology and the dictionary named in the
+ * options and searches them as the options say, except for --compile.
+ * Each topology gets its own instantiation, down to the search kernels.
+ * Returns the exit status of the program.
  */
-int main(int argc, char **argv) {
+template<typename grid>
+int searchGrid(const char *program, searchOptions options) {
 	//IO
-	const vector<string> layers = readLines< vector<string> >(argc, argv, 1, true);
-	const vector<string> dictionary = readLines< vector<string> >(argc, argv, 2, false);
+	searchReport report;
+	chrono::steady_clock::time_point readStart = chrono::steady_clock::now();
+	const char *honeycombPath = options.server ? NULL : options.arguments[0];
+	const char *dictionaryPath = options.arguments.back();
+	mappedFile honeycombFile, dictionaryFile;
+	vector<string_view> layers, dictionary; //in batch mode, layers are the lines of the whole file of boards
+	string dictionaryStorage; //folded words (see normaliseDictionary())
+	compiledDictionary compiled; //if the dictionary was compiled with --compile
+	neighborCache cache; //neighbors of the board sizes built (see buildBoard())
+	string error;
+	if ((honeycombPath != NULL && !readLines(honeycombPath, !options.batch, honeycombFile, layers, error)) ||
+		(!options.stream && !readDictionary(dictionaryPath, dictionaryFile, dictionary, dictionaryStorage, compiled, error)) ||
+		(options.neighborsPath != NULL && !loadNeighborCache(options.neighborsPath, cache, error))) {
+		cerr << program << ": " << error << endl;
+		return 1;
+	}
+	if (!options.batch && !grid::isBoard(layers)) {
+		cerr << program << ": " << honeycombPath << ": " << grid::shapeError << endl;
+		return 1;
+	}
+	if (options.stream && isCompiledFile(dictionaryPath)) {
+		cerr << program << ": " << dictionaryPath << ": compiled dictionaries cannot be used with --stream" << endl;
+		return 1;
+	}
+	if (compiled.isOpen()) {
+		if (options.server || options.count) {
+			cerr << program << ": " << dictionaryPath << ": compiled dictionaries cannot be used with " << (options.server ? "--server" : "--count") << endl;
+			return 1;
+		}
+		options.mode = TRIE_MODE; //compiled dictionaries are searched like the trie
+	}
+	report.readTime = getElapsed(readStart);
+
+	chrono::steady_clock::time_point trieStart = chrono::steady_clock::now();
+	dictionaryTrie trie;
+	if (usesTrie(options.mode) && !compiled.isOpen()) buildTrie(dictionary, trie);
+	report.trieTime = getElapsed(trieStart);
+
+	if (options.server) {
+		int status = runServer(dictionary, trie, cache, options);
+		return storeNeighbors(program, options, cache) ? status : 1;
+	}
+
+	if (options.batch) {
+		report.buildTime = report.trieTime;
+		chrono::steady_clock::time_point searchStart = chrono::steady_clock::now();
+		if (!runBatch<grid>(honeycombPath, layers, dictionary, trie, compiled, cache, options, report, error)) {
+			cerr << program << ": " << error << endl;
+			return 1;
+		}
+		report.searchTime = getElapsed(searchStart);
+		if (!storeNeighbors(program, options, cache)) return 1;
+
+		if (options.benchmark) printReport(report, options);
+		if (options.stats) printStats(report);
+		return 0;
+	}
 
 	//initialization
-	vector< vector<linkedPolygonNode<SIDES> *> > positionNodeArray; //array of vectors of nodes depicting position
-	linkedPolygonNode<SIDES> * linkedNodeArray[ALPHABET] = { NULL }; //an array of linked lists of nodes (one per letter)
-	populateLinkedNodeArray(layers, linkedNodeArray, positionNodeArray); //fill array with data from honeycomb
-	setNeighbors(positionNodeArray);
-
-	//iterate through words in dictionary and search
-	vector<string> found;
-	for (string word : dictionary) {
-		char first = word[0];
-		size_t bucket = getBucket(first);
-		linkedPolygonNode<SIDES> * current = linkedNodeArray[bucket]; //start of linked list
-
-		while (current != NULL) { //iterate through linked list
-			if (searchNodes(linkedNodeArray, word.substr(1), current)) { //found
-				found.push_back(word);
-				break;
-			}
+	chrono::steady_clock::time_point buildStart = chrono::steady_clock::now();
+	searchBoard<grid::adjacentN> board; //flat table of cells depicting position (or only their letters)
+	buildBoard<grid>(layers, options, board, report, options.neighborsPath != NULL ? &cache : NULL); //fill board with data from honeycomb and set neighbors
+	report.buildTime = getElapsed(buildStart);
+	if (!storeNeighbors(program, options, cache)) return 1;
 
-			current = current->nextPtr; //advance to next starter node in linked list
+	if (options.stream) {
+		chrono::steady_clock::time_point searchStart = chrono::steady_clock::now();
+		if (!runStream(board, dictionaryPath, options, report, error)) {
+			cerr << program << ": " << error << endl;
+			return 1;
 		}
+		report.searchTime = getElapsed(searchStart);
+
+		report.cells = board.cellCount;
+		if (options.benchmark) printReport(report, options);
+		if (options.stats) printStats(report);
+		return 0;
 	}
 
-	//use standard C++ sort and print
-	sort(found.begin(), found.end());
-	for (string word : found){
-		cout << word << endl;
+	vector<uint32_t> found;
+	vector<uint64_t> counts; //--count, by dictionary index
+	chrono::steady_clock::time_point searchStart = chrono::steady_clock::now();
+	if (options.count) countDictionary(board, dictionary, options, found, counts, report);
+	else if (compiled.isOpen()) searchCompiledDictionary(board, compiled, options, found, report);
+	else searchDictionary(board, dictionary, trie, options, found, report);
+	report.searchTime = getElapsed(searchStart);
+
+	//sort (unless the dictionary already is, as compiled ones are) and print
+	chrono::steady_clock::time_point outputStart = chrono::steady_clock::now();
+	if (!compiled.isOpen()) sortFound(dictionary, is_sorted(dictionary.begin(), dictionary.end()), found, options.threadCount);
+	report.sortTime = getElapsed(outputStart);
+
+	chrono::steady_clock::time_point writeStart = chrono::steady_clock::now();
+	{
+		bufferedWriter writer(stdout);
+		if (options.paths) writePaths<grid>(board.table, dictionary, compiled, found, writer);
+		else if (options.count) writeCounts(dictionary, found, counts, writer);
+		else if (compiled.isOpen()) writeCompiledFound(compiled, found, writer);
+		else writeFound(dictionary, found, writer);
 	}
+	report.writeTime = getElapsed(writeStart);
+	report.outputTime = getElapsed(outputStart);
 
-	//free dynamically allocated nodes
-	for (size_t layerN = 0; layerN < positionNodeArray.size(); layerN++) {
-		for (size_t charN = 0; charN < positionNodeArray[layerN].size(); charN++) {
-			delete(positionNodeArray[layerN][charN]);
+	report.words = compiled.isOpen() ? compiled.wordCount : dictionary.size();
+	report.cells = board.cellCount;
+	report.found = found.size();
+	if (options.benchmark) printReport(report, options);
+	if (options.stats) printStats(report);
+
+	return 0;
+}
+
+/*
+ * Function name: main(argc, argv)
+ * Main function that searches for given words in a given honeycomb
+ * Example usage: "./hexagonalSearch honeycomb.txt dictionary.txt"
+ * or "./hexagonalSearch --mode trie honeycomb.txt dictionary.txt"
+ * or "./hexagonalSearch --server dictionary.txt" (see runServer())
+ * or "./hexagonalSearch --stream honeycomb.txt dictionary.txt" (see runStream())
+ * or "./hexagonalSearch --batch honeycombs.txt dictionary.txt" (see runBatch())
+ * or "./hexagonalSearch --grid square8 grid.txt dictionary.txt" (see gridTopology.h)
+ * or "./hexagonalSearch --paths honeycomb.txt dictionary.txt" (see writePaths())
+ * or "./hexagonalSearch --count honeycomb.txt dictionary.txt" (see countDictionary())
+ * or "./hexagonalSearch --batch --neighbors neighbors.bin honeycombs.txt dictionary.txt" (see neighborCache.h)
+ * or "./hexagonalSearch --compile dictionary.txt dictionary.dawg", after which
+ * dictionary.dawg can be given in place of dictionary.txt
+ */
+int main(int argc, char **argv) {
+	searchOptions options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	if (options.compile) {
+		string error;
+		if (!compileFile(options.arguments[0], options.arguments[1], error)) {
+			cerr << argv[0] << ": " << error << endl;
+			return 1;
 		}
+		return 0;
 	}
 
-	return 0;
-}
\ No newline at end of file
+	switch (options.grid) {
+		case SQUARE4_GRID: return searchGrid< squareGrid<false> >(argv[0], options);
+		case SQUARE8_GRID: return searchGrid< squareGrid<true> >(argv[0], options);
+		case TRIANGLE_GRID: return searchGrid<triangleGrid>(argv[0], options);
+		default: return searchGrid<hexGrid>(argv[0], options);
+	}
+}
@@ -0,0 +1,111 @@
+/*
+ * File: implicitSearch.h
+ * -------------------------
+ * Trie-guided search over a honeycomb stored as nothing but
+ * its letters, one byte per cell in cell id order. Neighbors
+ * are derived on the fly with getNeighborCoordinates() instead
+ * of read from a cell table, so very large boards fit in memory.
+ */
+
+#ifndef IMPLICIT_SEARCH_H
+#define IMPLICIT_SEARCH_H
+
+/* Packages */
+#include <stdint.h>
+#include <string_view>
+#include <vector>
+
+#include "cellTable.h"
+#include "dictionaryTrie.h"
+#include "searchStats.h"
+
+/*
+ * Struct defining a honeycomb as its packed letters.
+ */
+struct implicitBoard
+{
+	/* Data */
+	size_t layerCount = 0;
+	std::vector<char> letters; //letter of each cell
+
+	/* Functions */
+	size_t getCellCount() const {
+		return letters.size();
+	}
+};
+
+/*
+ * Function name: populateImplicitBoard(layers, board)
+ * Fills a board with the letters of the layers of a honeycomb
+ * The layers must form a honeycomb (see isHoneycomb()).
+ */
+inline void populateImplicitBoard(const std::vector<std::string_view> &layers, implicitBoard &board) {
+	board.layerCount = layers.size();
+	board.letters.resize(layers.empty() ? 0 : getLayerStart(layers.size()));
+
+	for (size_t layerN = 0; layerN < layers.size(); layerN++) {
+		layers[layerN].copy(board.letters.data() + getLayerStart(layerN), layers[layerN].length());
+	}
+}
+
+/*
+ * Function name: searchImplicit(board, trie, nodeIndex, cell, visited, foundFlags, stats)
+ * Same as searchTrie() on a board without a neighbor table: the
+ * coordinates of the cell are carried down the recursion and the
+ * coordinates of its neighbors computed from them.
+ */
+template<bool countStats = false>
+inline void searchImplicit(const implicitBoard &board, const dictionaryTrie &trie, const uint32_t nodeIndex, const cellCoordinates cell, visitedSet &visited, std::vector<bool> &foundFlags, searchStats *stats = NULL) {
+	const dictionaryTrie::trieNode &node = trie.nodes[nodeIndex];
+	if (node.wordIndex >= 0) foundFlags[node.wordIndex] = true; //found!
+	if (node.childMask == 0) return; //no longer prefix in dictionary
+
+	uint32_t id = getLayerStart(cell.layerN) + cell.charN;
+	visited.set(id);
+	if (countStats) {
+		stats->enter();
+		stats->visits++;
+	}
+
+	cellCoordinates adjacentList[SIDES];
+	getNeighborCoordinates(board.layerCount, cell, adjacentList);
+
+	for (size_t neighborN = 0; neighborN < SIDES; neighborN++) { //iterate over neighbors
+		if (adjacentList[neighborN].layerN == NO_CELL) continue;
+
+		uint32_t neighbor = getLayerStart(adjacentList[neighborN].layerN) + adjacentList[neighborN].charN;
+		uint32_t child = visited.test(neighbor) ? 0 : trie.getChild(nodeIndex, board.letters[neighbor]);
+		if (child != 0) searchImplicit<countStats>(board, trie, child, adjacentList[neighborN], visited, foundFlags, stats); //depth-first recursion
+		else if (countStats) stats->pruned++;
+	}
+
+	//reset and back-track
+	visited.reset(id);
+	if (countStats) stats->leave();
+}
+
+/*
+ * Function name: searchImplicitCells(board, trie, begin, end, visited, foundFlags, stats)
+ * Starts a trie-guided search from every cell with an id in [begin, end)
+ */
+template<bool countStats = false>
+inline void searchImplicitCells(const implicitBoard &board, const dictionaryTrie &trie, const uint32_t begin, const uint32_t end, visitedSet &visited, std::vector<bool> &foundFlags, searchStats *stats = NULL) {
+	if (begin >= end) return;
+
+	cellCoordinates cell = getCellCoordinates(begin);
+	for (uint32_t id = begin; id < end; id++) {
+		uint32_t child = trie.getChild(0, board.letters[id]);
+		if (child != 0) {
+			if (countStats) stats->starts++;
+			searchImplicit<countStats>(board, trie, child, cell, visited, foundFlags, stats);
+		}
+
+		//advance to the next cell, moving out a layer at its end
+		if (++cell.charN == getLayerSize(cell.layerN)) {
+			cell.layerN++;
+			cell.charN = 0;
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,144 @@
+/*
+ * File: incrementalSearch.h
+ * -------------------------
+ * Incremental update of the words found on a honeycomb when
+ * the letters of a few of its cells change. A word can only
+ * stop being found if it had a path through a changed cell,
+ * and only start being found if it now has one, so only the
+ * paths through the changed cells are searched again, with a
+ * trie-guided search started from the cells near them.
+ */
+
+#ifndef INCREMENTAL_SEARCH_H
+#define INCREMENTAL_SEARCH_H
+
+/* Packages */
+#include <algorithm>
+#include <stdint.h>
+#include <string_view>
+#include <vector>
+
+#include "cellTable.h"
+#include "dictionaryTrie.h"
+#include "wordSearch.h"
+
+/*
+ * Struct defining the change of the letter of a single cell.
+ */
+struct cellChange
+{
+	uint32_t cell;
+	char value;
+};
+
+/*
+ * Function name: searchTrieThrough(table, trie, nodeIndex, cell, through, changed, visited, found)
+ * Same as searchTrie(), but only adds the dictionary indices of the
+ * words whose path goes through one of the given changed cells to a
+ * given vector (possibly more than once). Whether the path so far
+ * does is carried down the recursion.
+ */
+template<size_t adjacentN>
+inline void searchTrieThrough(const cellTable<adjacentN> &table, const dictionaryTrie &trie, const uint32_t nodeIndex, const uint32_t cell, bool through, const visitedSet &changed, visitedSet &visited, std::vector<uint32_t> &found) {
+	through = through || changed.test(cell);
+	const dictionaryTrie::trieNode &node = trie.nodes[nodeIndex];
+	if (node.wordIndex >= 0 && through) found.push_back(node.wordIndex); //found!
+	if (node.childMask == 0) return; //no longer prefix in dictionary
+
+	visited.set(cell);
+
+	for (size_t neighborN = 0; neighborN < adjacentN; neighborN++) { //iterate over neighbors
+		uint32_t neighbor = table.getNeighbor(cell, neighborN);
+		if (neighbor == NO_CELL || visited.test(neighbor)) continue;
+
+		uint32_t child = trie.getChild(nodeIndex, table.letters[neighbor]);
+		if (child != 0) searchTrieThrough(table, trie, child, neighbor, through, changed, visited, found); //depth-first recursion
+	}
+
+	//reset and back-track
+	visited.reset(cell);
+}
+
+/*
+ * Function name: searchThrough(table, trie, cells, maxLength, found)
+ * Sets a given vector to the sorted dictionary indices of the words
+ * of at most maxLength letters with a path through one of the given
+ * cells. Only the cells close enough to one of them to start such a
+ * path, found breadth-first, are searched from.
+ */
+template<size_t adjacentN>
+inline void searchThrough(const cellTable<adjacentN> &table, const dictionaryTrie &trie, const std::vector<uint32_t> &cells, const size_t maxLength, std::vector<uint32_t> &found) {
+	visitedSet changed(table.getCellCount());
+	for (uint32_t cell : cells) changed.set(cell);
+
+	//cells within maxLength - 1 steps of a changed cell
+	visitedSet reached = changed;
+	std::vector<uint32_t> starts(cells.begin(), cells.end());
+	std::sort(starts.begin(), starts.end());
+	starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+	size_t layerBegin = 0;
+	for (size_t distance = 1; distance < maxLength; distance++) {
+		size_t layerEnd = starts.size();
+		for (size_t startN = layerBegin; startN < layerEnd; startN++) {
+			for (size_t neighborN = 0; neighborN < adjacentN; neighborN++) {
+				uint32_t neighbor = table.getNeighbor(starts[startN], neighborN);
+				if (neighbor == NO_CELL || reached.test(neighbor)) continue;
+				reached.set(neighbor);
+				starts.push_back(neighbor);
+			}
+		}
+		layerBegin = layerEnd;
+	}
+
+	found.clear();
+	visitedSet visited(table.getCellCount());
+	for (uint32_t start : starts) {
+		uint32_t child = trie.getChild(0, table.letters[start]);
+		if (child != 0) searchTrieThrough(table, trie, child, start, false, changed, visited, found);
+	}
+
+	std::sort(found.begin(), found.end());
+	found.erase(std::unique(found.begin(), found.end()), found.end());
+}
+
+/*
+ * Function name: updateCells(table, dictionary, trie, changes, foundFlags, added, removed)
+ * Applies the given letter changes to a built cell table and updates
+ * the given flags of the dictionary words found on it, setting the
+ * given vectors to the sorted dictionary indices of the words that
+ * are now found and of those that no longer are. The trie must have
+ * been built from the dictionary.
+ * The words with a path through a changed cell are searched for before
+ * and after the change. Those only found before are searched for again
+ * on the whole board, in case they also have a path elsewhere.
+ */
+template<size_t adjacentN>
+inline void updateCells(cellTable<adjacentN> &table, const std::vector<std::string_view> &dictionary, const dictionaryTrie &trie, const std::vector<cellChange> &changes, std::vector<bool> &foundFlags, std::vector<uint32_t> &added, std::vector<uint32_t> &removed) {
+	size_t maxLength = 0;
+	for (std::string_view word : dictionary) maxLength = std::max(maxLength, word.length());
+
+	std::vector<uint32_t> cells;
+	for (const cellChange &change : changes) cells.push_back(change.cell);
+
+	std::vector<uint32_t> before, after;
+	searchThrough(table, trie, cells, maxLength, before);
+	for (const cellChange &change : changes) setCellLetter(table, change.cell, change.value);
+	searchThrough(table, trie, cells, maxLength, after);
+
+	added.clear();
+	for (uint32_t wordN : after) {
+		if (!foundFlags[wordN]) added.push_back(wordN);
+	}
+
+	removed.clear();
+	visitedSet visited(table.getCellCount());
+	for (uint32_t wordN : before) {
+		if (!foundFlags[wordN] || std::binary_search(after.begin(), after.end(), wordN)) continue;
+		if (!searchWord(table, dictionary[wordN], visited)) removed.push_back(wordN);
+	}
+
+	for (uint32_t wordN : added) foundFlags[wordN] = true;
+	for (uint32_t wordN : removed) foundFlags[wordN] = false;
+}
+
+#endif
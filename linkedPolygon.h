@@ -0,0 +1,159 @@
+/*
+ * File: linkedPolygon.h
+ * -------------------------
+ * The board and word search hexagonalSearch started from, kept
+ * as the baseline of the microbenchmark: every cell is a node
+ * allocated on its own, holding pointers to its neighbors and
+ * to the next node with its letter, and a word is searched for
+ * by recursing on the rest of it as a new string.
+ */
+
+#ifndef LINKED_POLYGON_H
+#define LINKED_POLYGON_H
+
+/* Packages */
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cellTable.h"
+
+/*
+ * Struct defining a polygonal structure of characters as nodes
+ * of characters. The nodes contain a value, pointers
+ * to each of its adjacent nodes, and a next pointer
+ * for use in linked lists.
+ * The null adjacent pointers, if any exist, are not
+ * necessarily at the end of the array.
+ * For hexagonal polygons, the adjacents should come
+ * in the predetermined order of lowest layer index to
+ * greatest and lowest sublayer index to greatest.
+ */
+template<size_t adjacentN = SIDES>
+struct linkedPolygonNode
+{
+	/* Data */
+	char value = 0;
+	size_t layerN = 0;
+	size_t charN = 0;
+	linkedPolygonNode * adjacentList[adjacentN] = { NULL };
+	linkedPolygonNode * nextPtr = NULL;
+	bool visited = false;
+
+	/* Functions */
+	linkedPolygonNode * getLastNode() {
+		linkedPolygonNode *current = this;
+		while (current->nextPtr != NULL) {
+			current = current->nextPtr;
+		}
+		return current;
+	}
+};
+
+/*
+ * Struct holding the nodes of a honeycomb, by position and as
+ * one linked list per letter. The nodes are dynamically
+ * allocated and freed with the polygon.
+ */
+struct linkedPolygon
+{
+	/* Data */
+	std::vector< std::vector< linkedPolygonNode<SIDES> * > > positionNodeArray; //array of vectors of nodes depicting position
+	linkedPolygonNode<SIDES> * linkedNodeArray[ALPHABET] = { NULL }; //an array of linked lists of nodes (one per letter)
+
+	/* Functions */
+	linkedPolygon() = default;
+	linkedPolygon(const linkedPolygon &) = delete;
+	linkedPolygon &operator=(const linkedPolygon &) = delete;
+
+	~linkedPolygon() {
+		for (std::vector< linkedPolygonNode<SIDES> * > &layer : positionNodeArray) {
+			for (linkedPolygonNode<SIDES> *node : layer) delete node;
+		}
+	}
+};
+
+/*
+ * Function name: populateLinkedPolygon(layers, polygon)
+ * Fills an empty polygon using a given polygon of characters.
+ * Iterates through the layers from lowest to greatest and links
+ * nodes during collisions, then sets the adjacent node pointers
+ * of all nodes from getNeighborCoordinates().
+ * The layers must form a honeycomb of capital letters.
+ */
+inline void populateLinkedPolygon(const std::vector<std::string_view> &layers, linkedPolygon &polygon) {
+	for (size_t layerN = 0; layerN < layers.size(); layerN++) {
+		std::string_view layer = layers[layerN];
+		polygon.positionNodeArray.emplace_back(); //create vector of nodes for current layer
+
+		for (size_t charN = 0; charN < layer.length(); charN++) {
+			linkedPolygonNode<SIDES> *newNode = new linkedPolygonNode<SIDES>;
+
+			//set values and coordinates
+			newNode->value = layer[charN];
+			newNode->layerN = layerN;
+			newNode->charN = charN;
+			polygon.positionNodeArray[layerN].push_back(newNode);
+
+			//set node in array of linked lists
+			size_t bucket = getBucket(newNode->value);
+			if (polygon.linkedNodeArray[bucket] == NULL) polygon.linkedNodeArray[bucket] = newNode; //set first node to new node
+			else polygon.linkedNodeArray[bucket]->getLastNode()->nextPtr = newNode; //set end of linked list to new node
+		}
+	}
+
+	for (std::vector< linkedPolygonNode<SIDES> * > &layer : polygon.positionNodeArray) {
+		for (linkedPolygonNode<SIDES> *current : layer) {
+			cellCoordinates neighbors[SIDES];
+			getNeighborCoordinates(layers.size(), { (uint32_t)current->layerN, (uint32_t)current->charN }, neighbors);
+			for (size_t neighborN = 0; neighborN < SIDES; neighborN++) {
+				if (neighbors[neighborN].layerN != NO_CELL) current->adjacentList[neighborN] = polygon.positionNodeArray[neighbors[neighborN].layerN][neighbors[neighborN].charN];
+			}
+		}
+	}
+}
+
+/*
+ * Function name: searchNodes(word, current)
+ * Searches the neighbors of a given node for a given word
+ * via recursive depth-first search
+ */
+inline bool searchNodes(const std::string word, linkedPolygonNode<SIDES> * current) {
+	if (current == NULL) return false; //dead-end
+	if (word.length() == 0) return true; //found!
+
+	char first = word[0];
+	current->visited = true;
+
+	for (size_t neighborN = 0; neighborN < SIDES; neighborN++) { //iterate over neighbors
+		linkedPolygonNode<SIDES> * neighbor = (current->adjacentList)[neighborN];
+
+		if (neighbor != NULL && neighbor->visited == false && neighbor->value == first) {
+			if (searchNodes(word.substr(1), neighbor)) {
+				current->visited = false;
+				return true; //depth-first recursion
+			}
+		}
+	}
+
+	//reset and back-track
+	current->visited = false;
+	return false;
+}
+
+/*
+ * Function name: searchLinkedPolygon(polygon, word)
+ * Returns whether a given word of capital letters is in a given
+ * polygon, trying the nodes with its first letter one by one
+ */
+inline bool searchLinkedPolygon(const linkedPolygon &polygon, const std::string_view word) {
+	if (word.empty()) return false;
+
+	std::string rest(word.substr(1));
+	for (linkedPolygonNode<SIDES> *current = polygon.linkedNodeArray[getBucket(word[0])]; current != NULL; current = current->nextPtr) { //iterate through linked list
+		if (searchNodes(rest, current)) return true; //found
+	}
+	return false;
+}
+
+#endif
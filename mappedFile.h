@@ -0,0 +1,105 @@
+/*
+ * File: mappedFile.h
+ * -------------------------
+ * Read-only memory mapping of an input file, split into
+ * lines that are views into the mapping, so loading a file
+ * copies nothing and allocates only the array of views.
+ * The views stay valid for as long as the mapping is open.
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+/* Packages */
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+/*
+ * Struct owning a read-only memory mapping of a whole file.
+ * Empty files are represented by a null mapping of size 0.
+ */
+struct mappedFile
+{
+	/* Data */
+	const char *data = NULL;
+	size_t size = 0;
+
+	/* Functions */
+	mappedFile() {}
+	mappedFile(const mappedFile &) = delete;
+	mappedFile & operator=(const mappedFile &) = delete;
+	~mappedFile() {
+		close();
+	}
+
+	//maps the file at a given path, setting error and returning false on failure
+	bool open(const char *path, std::string &error) {
+		close();
+
+		int descriptor = ::open(path, O_RDONLY);
+		if (descriptor < 0) {
+			error = std::string(path) + ": " + strerror(errno);
+			return false;
+		}
+
+		struct stat status;
+		if (fstat(descriptor, &status) < 0) {
+			error = std::string(path) + ": " + strerror(errno);
+			::close(descriptor);
+			return false;
+		}
+
+		if (status.st_size > 0) {
+			void *mapping = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+			if (mapping == MAP_FAILED) {
+				error = std::string(path) + ": " + strerror(errno);
+				::close(descriptor);
+				return false;
+			}
+			madvise(mapping, status.st_size, MADV_SEQUENTIAL);
+
+			data = (const char *)mapping;
+			size = status.st_size;
+		}
+
+		::close(descriptor); //the mapping stays valid after closing
+		return true;
+	}
+
+	void close() {
+		if (data != NULL) munmap((void *)data, size);
+		data = NULL;
+		size = 0;
+	}
+};
+
+/*
+ * Function name: splitLines(data, size, lines)
+ * Appends a view of every line of a given buffer to a given vector.
+ * Line endings (\n or \r\n) are not part of the views and a final
+ * line without an ending is kept.
+ */
+inline void splitLines(const char *data, const size_t size, std::vector<std::string_view> &lines) {
+	const char *current = data;
+	const char *end = data + size;
+
+	while (current < end) {
+		const char *lineEnd = (const char *)memchr(current, '\n', end - current);
+		if (lineEnd == NULL) lineEnd = end;
+
+		size_t length = lineEnd - current;
+		if (length > 0 && current[length - 1] == '\r') length--;
+		lines.push_back(std::string_view(current, length));
+
+		current = lineEnd + 1;
+	}
+}
+
+#endif
@@ -0,0 +1,549 @@
+/*
+ * File: microBenchmark.cpp
+ * -------------------------
+ * Benchmarks of the individual kernels of hexagonalSearch,
+ * to validate optimisations of one kernel without the noise
+ * of the rest of a search: building the cell table, the word
+ * searches on words that are found and on words that are not,
+ * starting from the node-based search hexagonalSearch started from
+ * (see linkedPolygon.h) as the baseline, which the other word
+ * searches are checked to agree with before any timing,
+ * the neighbors computed on the fly (checked against the table's first),
+ * the trie-guided walks, on one thread and on several, and
+ * the sorting and writing of the results. The inputs are generated in memory from a fixed
+ * seed (see randomInput.h), so runs are comparable.
+ * Every kernel is timed over a number of samples, each running
+ * it over all of its inputs, repeated until the sample lasts
+ * at least a millisecond, and reported on one line of key=value
+ * pairs as the mean time and cycles per operation with their
+ * 95% confidence intervals. Cycles are read from the time stamp
+ * counter, which ticks at a fixed rate on modern CPUs rather
+ * than with the core clock, and are reported as 0 on CPUs
+ * without one.
+ */
+
+/* Packages */
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <math.h>
+#include <random>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "bufferedWriter.h"
+#include "cellTable.h"
+#include "compiledDictionary.h"
+#include "dictionaryTrie.h"
+#include "implicitSearch.h"
+#include "incrementalSearch.h"
+#include "linkedPolygon.h"
+#include "lockstepSearch.h"
+#include "pathCount.h"
+#include "randomInput.h"
+#include "wordSearch.h"
+#include "workStealing.h"
+
+/* Namespace */
+using namespace std;
+
+/*
+ * Sum of the results of the kernels, kept so that the compiler
+ * cannot drop the work that produces them.
+ */
+static volatile size_t sink = 0;
+
+/*
+ * Two-sided 95% quantiles of Student's t distribution, indexed by
+ * degrees of freedom minus one, for the confidence intervals.
+ */
+const double T_QUANTILES[30] = {
+	12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+	2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+	2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+/*
+ * Struct holding the options given on the command line.
+ */
+struct benchmarkOptions
+{
+	size_t layers = 50; //of the board of all kernels but lockstep and search_by_size, which need a small one
+	size_t words = 20000; //found and not found each
+	size_t samples = 10;
+	size_t threads = 4; //of the threaded trie searches
+	size_t seed = 1;
+	string letters = "english"; //uniform, english or skewed
+	const char *filter = NULL; //if set, only the kernels whose name contains it are run
+};
+
+/*
+ * Function name: printUsage(program)
+ * Prints the command line usage to standard error
+ */
+void printUsage(const char *program) {
+	cerr << "Usage: " << program << " [--layers N] [--words N] [--samples N] [--threads N] [--seed S] [--letters uniform|english|skewed] [--filter NAME]" << endl;
+}
+
+/*
+ * Function name: parseOptions(argc, argv, options)
+ * Parses the command line into a given options struct.
+ * Returns false if the command line is invalid.
+ */
+bool parseOptions(int argc, char **argv, benchmarkOptions &options) {
+	for (int argn = 1; argn < argc; argn++) {
+		string option = argv[argn];
+		if (++argn == argc) return false;
+		string value = argv[argn];
+
+		if (option == "--letters") {
+			if (value != "uniform" && value != "english" && value != "skewed") return false;
+			options.letters = value;
+			continue;
+		} else if (option == "--filter") {
+			options.filter = argv[argn];
+			continue;
+		}
+
+		char *end;
+		size_t number = strtoul(value.c_str(), &end, 10);
+		if (value.empty() || *end != '\0') return false;
+
+		if (option == "--layers") options.layers = number;
+		else if (option == "--words") options.words = number;
+		else if (option == "--samples") options.samples = number;
+		else if (option == "--threads") options.threads = number;
+		else if (option == "--seed") options.seed = number;
+		else return false;
+	}
+	return options.layers > 0 && options.samples > 1 && options.threads > 0;
+}
+
+/*
+ * Function name: readCycles()
+ * Returns the time stamp counter of the CPU, or 0 where there is none
+ */
+inline uint64_t readCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+/*
+ * Function name: getInterval(samples, mean, halfWidth)
+ * Sets the mean of given samples and the half-width of its 95%
+ * confidence interval
+ */
+void getInterval(const vector<double> &samples, double &mean, double &halfWidth) {
+	mean = 0;
+	for (double sample : samples) mean += sample;
+	mean /= samples.size();
+
+	double variance = 0;
+	for (double sample : samples) variance += (sample - mean) * (sample - mean);
+	variance /= samples.size() - 1;
+
+	size_t degrees = samples.size() - 1;
+	halfWidth = (degrees <= 30 ? T_QUANTILES[degrees - 1] : 1.96) * sqrt(variance / samples.size());
+}
+
+/*
+ * Function name: runBenchmark(name, ops, options, kernel)
+ * Times kernel(), which performs a given number of operations and
+ * returns a value for the sink, and prints its time and cycles per
+ * operation to standard output, unless filtered out by the options.
+ * A first run warms the caches and sets how many runs make up a
+ * sample of at least a millisecond.
+ */
+template<typename F>
+void runBenchmark(const char *name, const size_t ops, const benchmarkOptions &options, F kernel) {
+	if ((options.filter != NULL && strstr(name, options.filter) == NULL) || ops == 0) return;
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	sink = sink + kernel();
+	double warmup = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+	size_t repeats = max<size_t>(1, (size_t)(1e6 / max(warmup, 1.0)));
+
+	vector<double> nanos(options.samples), cycles(options.samples);
+	for (size_t sampleN = 0; sampleN < options.samples; sampleN++) {
+		start = chrono::steady_clock::now();
+		uint64_t startCycles = readCycles();
+		for (size_t repeatN = 0; repeatN < repeats; repeatN++) sink = sink + kernel();
+		uint64_t endCycles = readCycles();
+		nanos[sampleN] = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / (ops * repeats);
+		cycles[sampleN] = (double)(endCycles - startCycles) / (ops * repeats);
+	}
+
+	double nanoMean, nanoWidth, cycleMean, cycleWidth;
+	getInterval(nanos, nanoMean, nanoWidth);
+	getInterval(cycles, cycleMean, cycleWidth);
+	cout << "kernel=" << name
+		<< " ops=" << ops
+		<< " samples=" << options.samples
+		<< " repeats=" << repeats
+		<< " ns_per_op=" << nanoMean
+		<< " ns_ci95=" << nanoWidth
+		<< " cycles_per_op=" << cycleMean
+		<< " cycles_ci95=" << cycleWidth
+		<< endl;
+}
+
+/*
+ * Struct holding a honeycomb generated in memory, its cell table and
+ * words found and not found on it.
+ */
+struct benchmarkBoard
+{
+	/* Data */
+	vector<string> layerStrings;
+	vector<string_view> layers;
+	cellTable<SIDES> table;
+	vector<string> hitStrings, missStrings;
+	vector<string_view> hits, misses;
+};
+
+/*
+ * Function name: generateBoard(layerCount, wordCount, options, random, board)
+ * Fills a given board with a random honeycomb of a given number of
+ * layers and as many words found on it (read off its paths, see
+ * readPathWord()) as random words not found on it, of 3 to 10 letters
+ */
+void generateBoard(const size_t layerCount, const size_t wordCount, const benchmarkOptions &options, mt19937_64 &random, benchmarkBoard &board) {
+	discrete_distribution<size_t> letter = makeLetterDistribution(options.letters);
+	uniform_int_distribution<size_t> length(3, 10);
+
+	board.layerStrings.resize(layerCount);
+	for (size_t layerN = 0; layerN < layerCount; layerN++) {
+		board.layerStrings[layerN].resize(getLayerSize(layerN));
+		for (char &value : board.layerStrings[layerN]) value = 'A' + letter(random);
+	}
+	board.layers.assign(board.layerStrings.begin(), board.layerStrings.end());
+	buildCellTable(board.layers, board.table);
+
+	visitedSet visited(board.table.getCellCount());
+	string word;
+	for (size_t tries = 0; board.hitStrings.size() < wordCount && tries < 100 * wordCount; tries++) {
+		if (readPathWord(board.table, length(random), random, word)) board.hitStrings.push_back(word);
+	}
+	for (size_t tries = 0; board.missStrings.size() < wordCount && tries < 100 * wordCount; tries++) {
+		word.resize(length(random));
+		for (char &value : word) value = 'A' + letter(random);
+		if (!searchWord(board.table, word, visited)) board.missStrings.push_back(word);
+	}
+	board.hits.assign(board.hitStrings.begin(), board.hitStrings.end());
+	board.misses.assign(board.missStrings.begin(), board.missStrings.end());
+}
+
+/*
+ * Function name: countHits(words, search)
+ * Returns how many of the given words search(word) finds
+ */
+template<typename F>
+size_t countHits(const vector<string_view> &words, F search) {
+	size_t hits = 0;
+	for (string_view word : words) hits += search(word);
+	return hits;
+}
+
+/*
+ * Function name: matchesCellNeighbors(table)
+ * Returns whether getCellNeighbors() gives every cell of a honeycomb
+ * cell table the neighbors setNeighbors() set in the table
+ */
+bool matchesCellNeighbors(const cellTable<SIDES> &table) {
+	uint32_t adjacentList[SIDES];
+	for (uint32_t cell = 0; cell < table.getCellCount(); cell++) {
+		getCellNeighbors(table.getLayerCount(), cell, adjacentList);
+		for (size_t neighborN = 0; neighborN < SIDES; neighborN++) {
+			if (adjacentList[neighborN] != table.getNeighbor(cell, neighborN)) return false;
+		}
+	}
+	return true;
+}
+
+/*
+ * Function name: runThreads(threadCount, work)
+ * Runs work(threadN) for every thread number below a given count, each
+ * on its own thread (the last on the calling thread), and waits for all
+ * of them to finish, as the threaded searches of hexagonalSearch do
+ */
+template<typename F>
+void runThreads(const size_t threadCount, F work) {
+	vector<thread> workers;
+	for (size_t threadN = 0; threadN + 1 < threadCount; threadN++) workers.emplace_back(work, threadN);
+	work(threadCount - 1);
+	for (thread &worker : workers) worker.join();
+}
+
+/*
+ * Function name: main(argc, argv)
+ * Example usage: "./microBenchmark --layers 100 --words 50000"
+ * or "./microBenchmark --filter search_word" to run the kernels with
+ * search_word in their name only
+ */
+int main(int argc, char **argv) {
+	benchmarkOptions options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	//inputs: a board for the kernels, a board small enough for lockstep and the fixed-size kernels, and a dictionary of both their words
+	mt19937_64 random(options.seed);
+	benchmarkBoard board, small;
+	generateBoard(options.layers, options.words, options, random, board);
+	generateBoard(5, min<size_t>(options.words, 2000), options, random, small);
+	const cellTable<SIDES> &table = board.table;
+
+	vector<string_view> dictionary(board.hits);
+	dictionary.insert(dictionary.end(), board.misses.begin(), board.misses.end());
+	shuffle(dictionary.begin(), dictionary.end(), random);
+	vector<string_view> sortedDictionary(dictionary);
+	sort(sortedDictionary.begin(), sortedDictionary.end());
+	sortedDictionary.erase(unique(sortedDictionary.begin(), sortedDictionary.end()), sortedDictionary.end());
+	size_t maxLength = 0;
+	for (string_view word : dictionary) maxLength = max(maxLength, word.length());
+
+	dictionaryTrie trie;
+	buildTrie(dictionary, trie);
+	vector<char> compiledData;
+	compileDictionary(dictionary, compiledData);
+	compiledDictionary compiled;
+	string error;
+	if (!compiled.open(compiledData.data(), compiledData.size(), error)) {
+		cerr << argv[0] << ": " << error << endl;
+		return 1;
+	}
+
+	//the neighbors computed on the fly must be those of the tables, on the boards searched and on the smallest honeycombs
+	vector<string> blankStrings;
+	for (size_t layerCount = 1; layerCount <= 8; layerCount++) {
+		blankStrings.emplace_back(getLayerSize(layerCount - 1), 'A');
+		vector<string_view> blank(blankStrings.begin(), blankStrings.end());
+		cellTable<SIDES> blankTable;
+		buildCellTable(blank, blankTable);
+		if (!matchesCellNeighbors(blankTable)) {
+			cerr << argv[0] << ": getCellNeighbors() disagrees with setNeighbors() on " << layerCount << " layers" << endl;
+			return 1;
+		}
+	}
+	if (!matchesCellNeighbors(table) || !matchesCellNeighbors(small.table)) {
+		cerr << argv[0] << ": getCellNeighbors() disagrees with setNeighbors() on the generated boards" << endl;
+		return 1;
+	}
+
+	//the word searches must find the words the baseline finds
+	linkedPolygon baseline;
+	populateLinkedPolygon(board.layers, baseline);
+	visitedSet visited(table.getCellCount());
+	vector<searchFrame> stack(max<size_t>(maxLength, 1)); //a frame per letter of the longest word
+	for (const vector<string_view> *words : { &board.hits, &board.misses }) {
+		for (string_view word : *words) {
+			bool found = searchLinkedPolygon(baseline, word);
+			if (searchWord(table, word, visited) != found || searchWordIterative(table, word, visited, stack.data()) != found || searchWordAnchored(table, word, visited) != found) {
+				cerr << argv[0] << ": the word searches disagree with the baseline on " << word << endl;
+				return 1;
+			}
+		}
+	}
+
+	cout << "inputs layers=" << options.layers
+		<< " cells=" << table.getCellCount()
+		<< " hits=" << board.hits.size()
+		<< " misses=" << board.misses.size()
+		<< " letters=" << options.letters
+		<< " seed=" << options.seed
+		<< endl;
+
+	//building the board, on copies of the boards the other kernels search
+	cellTable<SIDES> buildTable;
+	buildCellTable(board.layers, buildTable);
+	implicitBoard implicit;
+	populateImplicitBoard(board.layers, implicit);
+	lockstepBoard lockstep;
+	buildLockstepBoard(small.table, lockstep);
+	runBenchmark("populate", 1, options, [&]() {
+		populateCellTable(board.layers, buildTable);
+		return buildTable.bucketStart[ALPHABET];
+	});
+	runBenchmark("set_neighbors", 1, options, [&]() {
+		setNeighbors(buildTable);
+		return (size_t)buildTable.neighbors[0];
+	});
+	runBenchmark("cell_neighbors", table.getCellCount(), options, [&]() {
+		uint32_t adjacentList[SIDES];
+		size_t sum = 0;
+		for (uint32_t cell = 0; cell < table.getCellCount(); cell++) {
+			getCellNeighbors(table.getLayerCount(), cell, adjacentList);
+			sum += adjacentList[0];
+		}
+		return sum;
+	});
+	runBenchmark("neighbor_letters", 1, options, [&]() {
+		setNeighborLetters(buildTable);
+		setAdjacentLetters(buildTable);
+		return (size_t)buildTable.adjacentLetters[0];
+	});
+	runBenchmark("implicit_populate", 1, options, [&]() {
+		implicitBoard built;
+		populateImplicitBoard(board.layers, built);
+		return built.getCellCount();
+	});
+	runBenchmark("lockstep_board", 1, options, [&]() {
+		lockstepBoard built;
+		buildLockstepBoard(small.table, built);
+		return (size_t)built.usable;
+	});
+
+	//searches for one word at a time, on words found and on words not found
+	runBenchmark("letter_filter", dictionary.size(), options, [&]() {
+		return countHits(dictionary, [&](string_view word) { return passesLetterFilter(table, word); });
+	});
+	for (size_t hit = 0; hit < 2; hit++) {
+		const vector<string_view> &words = hit ? board.hits : board.misses;
+		string suffix = hit ? "_hit" : "_miss";
+		runBenchmark(("search_baseline" + suffix).c_str(), words.size(), options, [&]() {
+			return countHits(words, [&](string_view word) { return searchLinkedPolygon(baseline, word); });
+		});
+		runBenchmark(("search_word" + suffix).c_str(), words.size(), options, [&]() {
+			return countHits(words, [&](string_view word) { return searchWord(table, word, visited); });
+		});
+		runBenchmark(("search_iterative" + suffix).c_str(), words.size(), options, [&]() {
+			return countHits(words, [&](string_view word) { return searchWordIterative(table, word, visited, stack.data()); });
+		});
+		runBenchmark(("search_anchored" + suffix).c_str(), words.size(), options, [&]() {
+			return countHits(words, [&](string_view word) { return searchWordAnchored(table, word, visited); });
+		});
+	}
+	runBenchmark("search_memo", sortedDictionary.size(), options, [&]() {
+		searchMemo memo;
+		return countHits(sortedDictionary, [&](string_view word) { return searchWordMemo(table, word, visited, stack.data(), memo); });
+	});
+
+	//the same on the small board, on which searchWordBySize() takes the fixed-size kernels
+	for (size_t hit = 0; hit < 2; hit++) {
+		const vector<string_view> &words = hit ? small.hits : small.misses;
+		string suffix = hit ? "_hit" : "_miss";
+		runBenchmark(("search_word_small" + suffix).c_str(), words.size(), options, [&]() {
+			return countHits(words, [&](string_view word) { return searchWord(small.table, word, visited); });
+		});
+		runBenchmark(("search_by_size" + suffix).c_str(), words.size(), options, [&]() {
+			return countHits(words, [&](string_view word) { return searchWordBySize(small.table, word, visited); });
+		});
+	}
+
+	vector<string_view> smallWords(small.hits);
+	smallWords.insert(smallWords.end(), small.misses.begin(), small.misses.end());
+	vector<lockstepResult> results(smallWords.size());
+	runBenchmark("search_lockstep", smallWords.size(), options, [&]() {
+		searchLockstep(lockstep, smallWords.data(), smallWords.size(), results.data());
+		return (size_t)results[0];
+	});
+
+	pathCounter counter;
+	preparePathCounter(table, maxLength, counter);
+	runBenchmark("count_paths_hit", board.hits.size(), options, [&]() {
+		size_t paths = 0;
+		for (string_view word : board.hits) {
+			countWalks(table, word, counter);
+			paths += countPaths(table, word, 0, table.getBucketSize(getBucket(word[0])), counter);
+		}
+		return paths;
+	});
+
+	//walks of the whole board guided by the dictionary, per start cell
+	runBenchmark("trie_build", dictionary.size(), options, [&]() {
+		dictionaryTrie built;
+		buildTrie(dictionary, built);
+		return built.nodes.size();
+	});
+	vector<bool> foundFlags(dictionary.size());
+	runBenchmark("trie_search", table.getCellCount(), options, [&]() {
+		searchCells(table, trie, 0, table.getCellCount(), visited, foundFlags);
+		return (size_t)foundFlags[0];
+	});
+
+	//the same on several threads, with a fixed share of the cells each or balanced by work stealing
+	vector<visitedSet> threadVisited(options.threads, visitedSet(table.getCellCount()));
+	vector< vector<bool> > threadFlags(options.threads, vector<bool>(dictionary.size()));
+	runBenchmark("trie_search_threads", table.getCellCount(), options, [&]() {
+		runThreads(options.threads, [&](size_t threadN) {
+			uint32_t begin = table.getCellCount() * threadN / options.threads;
+			uint32_t end = table.getCellCount() * (threadN + 1) / options.threads;
+			searchCells(table, trie, begin, end, threadVisited[threadN], threadFlags[threadN]);
+		});
+		return (size_t)threadFlags[0][0];
+	});
+	stealingScheduler scheduler;
+	runBenchmark("trie_search_stealing", table.getCellCount(), options, [&]() {
+		scheduler.reset(options.threads, 1);
+		vector<workerLoad> loads(options.threads);
+		for (size_t threadN = 0; threadN < options.threads; threadN++) {
+			seedRange(scheduler, table.getCellCount() * threadN / options.threads, table.getCellCount() * (threadN + 1) / options.threads, threadN);
+		}
+		runThreads(options.threads, [&](size_t threadN) {
+			searchCellsStealing(table, trie, scheduler, threadN, threadVisited[threadN], threadFlags[threadN], loads[threadN]);
+		});
+		return (size_t)threadFlags[0][0];
+	});
+	runBenchmark("implicit_search", implicit.getCellCount(), options, [&]() {
+		searchImplicitCells(implicit, trie, 0, implicit.getCellCount(), visited, foundFlags);
+		return (size_t)foundFlags[0];
+	});
+	vector<bool> compiledFlags(compiled.wordCount);
+	runBenchmark("compiled_search", table.getCellCount(), options, [&]() {
+		searchCompiledCells(table, compiled, 0, table.getCellCount(), visited, compiledFlags);
+		return (size_t)compiledFlags[0];
+	});
+
+	//incremental updates, each changing a cell and changing it back
+	cellTable<SIDES> updateTable;
+	buildCellTable(board.layers, updateTable);
+	vector<bool> updateFlags(dictionary.size(), false);
+	for (size_t wordN = 0; wordN < dictionary.size(); wordN++) updateFlags[wordN] = searchWord(updateTable, dictionary[wordN], visited);
+	vector<cellChange> changes(1), restores(1);
+	vector<uint32_t> added, removed;
+	runBenchmark("update_cells", 2, options, [&]() {
+		changes[0] = { (uint32_t)(table.getCellCount() / 2), (char)(updateTable.letters[table.getCellCount() / 2] == 'E' ? 'T' : 'E') };
+		restores[0] = { changes[0].cell, updateTable.letters[changes[0].cell] };
+		updateCells(updateTable, dictionary, trie, changes, updateFlags, added, removed);
+		size_t changed = added.size() + removed.size();
+		updateCells(updateTable, dictionary, trie, restores, updateFlags, added, removed);
+		return changed + added.size() + removed.size();
+	});
+
+	//output, per word found
+	vector<uint32_t> order(dictionary.size()), found;
+	for (size_t wordN = 0; wordN < dictionary.size(); wordN++) order[wordN] = wordN;
+	runBenchmark("sort_found", order.size(), options, [&]() {
+		found = order;
+		sort(found.begin(), found.end(), [&](uint32_t a, uint32_t b) { return dictionary[a] < dictionary[b]; });
+		return (size_t)found[0];
+	});
+	FILE *null = fopen("/dev/null", "w");
+	if (null != NULL) {
+		{
+			bufferedWriter writer(null);
+			runBenchmark("write_found", found.size(), options, [&]() {
+				for (uint32_t wordN : found) writer.writeLine(dictionary[wordN]);
+				writer.flush();
+				return writer.used;
+			});
+		}
+		fclose(null);
+	}
+
+	return 0;
+}
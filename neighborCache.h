@@ -0,0 +1,208 @@
+/*
+ * File: neighborCache.h
+ * -------------------------
+ * Cache of the neighbor ids of cell tables. They depend only
+ * on the topology of a board and its size (its layer and cell
+ * counts), not on its letters, so boards of a size seen before
+ * get them by copying the cached table instead of computing
+ * them again. The cache can be saved to a binary file and
+ * loaded from it, so that later runs start with the tables of
+ * the sizes they are likely to meet. The file is written in
+ * the byte order of the machine.
+ */
+
+#ifndef NEIGHBOR_CACHE_H
+#define NEIGHBOR_CACHE_H
+
+/* Packages */
+#include <algorithm>
+#include <deque>
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "cellTable.h"
+#include "mappedFile.h"
+
+/* Macros */
+#define NEIGHBOR_CACHE_MAGIC "HEXNBRS1"
+#define NEIGHBOR_CACHE_TABLES 16 //tables kept, the oldest dropped first
+
+/*
+ * Struct defining the header at the start of a neighbor cache file,
+ * followed by tableCount tables.
+ */
+struct neighborFileHeader
+{
+	char magic[8];
+	uint64_t tableCount;
+};
+
+/*
+ * Struct defining the header of a table in a neighbor cache file,
+ * followed by its cellCount * adjacentN neighbor ids.
+ */
+struct neighborTableHeader
+{
+	char grid[16]; //name of the topology, zero-padded
+	uint64_t layerCount;
+	uint64_t cellCount;
+	uint64_t adjacentN;
+};
+
+/*
+ * Struct holding the neighbor ids of the cell tables of a few board
+ * sizes, each table keyed by its topology and size.
+ */
+struct neighborCache
+{
+	/* Types */
+	struct neighborTable
+	{
+		std::string grid;
+		size_t layerCount;
+		size_t cellCount;
+		size_t adjacentN; //neighbor slots per cell
+		std::vector<uint32_t> neighbors;
+	};
+
+	/* Data */
+	std::deque<neighborTable> tables; //oldest first
+	bool changed = false; //whether tables were added since it was loaded
+	size_t hits = 0; //lookups that found a table
+
+	/* Functions */
+	//returns the neighbor ids of the boards of a given topology and size, or NULL if not cached
+	const std::vector<uint32_t> *find(const std::string &grid, const size_t layerCount, const size_t cellCount, const size_t adjacentN) {
+		for (const neighborTable &table : tables) {
+			if (table.layerCount == layerCount && table.cellCount == cellCount && table.adjacentN == adjacentN && table.grid == grid) {
+				hits++;
+				return &table.neighbors;
+			}
+		}
+		return NULL;
+	}
+
+	void add(const std::string &grid, const size_t layerCount, const size_t cellCount, const size_t adjacentN, const uint32_t *neighbors) {
+		if (tables.size() == NEIGHBOR_CACHE_TABLES) tables.pop_front();
+		tables.push_back({ grid, layerCount, cellCount, adjacentN, std::vector<uint32_t>(neighbors, neighbors + cellCount * adjacentN) });
+		changed = true;
+	}
+};
+
+/*
+ * Function name: setCachedNeighbors<grid>(table, cache)
+ * Sets the neighbor ids of a populated cell table of a given topology
+ * (see gridTopology.h) from a given cache, computing them and adding
+ * them to the cache if its size is not in it yet
+ */
+template<typename grid>
+inline void setCachedNeighbors(cellTable<grid::adjacentN> &table, neighborCache &cache) {
+	size_t count = table.getCellCount() * grid::adjacentN;
+	const std::vector<uint32_t> *cached = cache.find(grid::name, table.getLayerCount(), table.getCellCount(), grid::adjacentN);
+	if (cached != NULL && cached->size() == count) {
+		memcpy(table.neighbors, cached->data(), count * sizeof(uint32_t));
+		return;
+	}
+
+	grid::setNeighbors(table);
+	cache.add(grid::name, table.getLayerCount(), table.getCellCount(), grid::adjacentN, table.neighbors);
+}
+
+/*
+ * Function name: loadNeighborCache(path, cache, error)
+ * Fills a given cache with the tables of the neighbor cache file at a
+ * given path, if there is one (a missing file is an empty cache).
+ * Returns false and sets error if the file cannot be read or is not a
+ * neighbor cache file, including if a table has a neighbor id that is
+ * neither NO_CELL nor the id of one of its cells.
+ */
+inline bool loadNeighborCache(const char *path, neighborCache &cache, std::string &error) {
+	if (access(path, F_OK) != 0 && errno == ENOENT) return true;
+
+	mappedFile file;
+	if (!file.open(path, error)) return false;
+
+	neighborFileHeader header;
+	if (file.size < sizeof(header) || memcmp(file.data, NEIGHBOR_CACHE_MAGIC, sizeof(header.magic)) != 0) {
+		error = std::string(path) + ": not a neighbor cache file";
+		return false;
+	}
+	memcpy(&header, file.data, sizeof(header));
+
+	size_t offset = sizeof(header);
+	for (uint64_t tableN = 0; tableN < header.tableCount; tableN++) {
+		neighborTableHeader table;
+		if (file.size - offset < sizeof(table)) break;
+		memcpy(&table, file.data + offset, sizeof(table));
+		offset += sizeof(table);
+
+		if (table.adjacentN == 0 || table.adjacentN > 8 || table.cellCount >= NO_CELL) {
+			error = std::string(path) + ": neighbor cache file has a malformed table";
+			return false;
+		}
+		if ((file.size - offset) / sizeof(uint32_t) / table.adjacentN < table.cellCount) break;
+		size_t count = table.cellCount * table.adjacentN;
+		std::vector<uint32_t> neighbors(count);
+		memcpy(neighbors.data(), file.data + offset, count * sizeof(uint32_t));
+		offset += count * sizeof(uint32_t);
+
+		for (uint32_t neighbor : neighbors) {
+			if (neighbor != NO_CELL && neighbor >= table.cellCount) {
+				error = std::string(path) + ": neighbor cache file has a neighbor id out of range";
+				return false;
+			}
+		}
+
+		if (cache.tables.size() == NEIGHBOR_CACHE_TABLES) cache.tables.pop_front();
+		cache.tables.push_back({ std::string(table.grid, strnlen(table.grid, sizeof(table.grid))), table.layerCount, table.cellCount, table.adjacentN, std::move(neighbors) });
+	}
+	if (cache.tables.size() != std::min<uint64_t>(header.tableCount, NEIGHBOR_CACHE_TABLES)) {
+		error = std::string(path) + ": neighbor cache file is truncated";
+		return false;
+	}
+	return true;
+}
+
+/*
+ * Function name: saveNeighborCache(path, cache, error)
+ * Writes the tables of a given cache to a neighbor cache file at a
+ * given path, through a temporary file renamed over it, so that runs
+ * reading it concurrently see either the old or the new cache.
+ * Returns false and sets error if the file cannot be written.
+ */
+inline bool saveNeighborCache(const char *path, const neighborCache &cache, std::string &error) {
+	std::string temporary = std::string(path) + ".tmp";
+	FILE *output = fopen(temporary.c_str(), "wb");
+	if (output == NULL) {
+		error = temporary + ": " + strerror(errno);
+		return false;
+	}
+
+	neighborFileHeader header;
+	memcpy(header.magic, NEIGHBOR_CACHE_MAGIC, sizeof(header.magic));
+	header.tableCount = cache.tables.size();
+	bool written = fwrite(&header, sizeof(header), 1, output) == 1;
+	for (const neighborCache::neighborTable &table : cache.tables) {
+		neighborTableHeader tableHeader = {};
+		table.grid.copy(tableHeader.grid, sizeof(tableHeader.grid) - 1);
+		tableHeader.layerCount = table.layerCount;
+		tableHeader.cellCount = table.cellCount;
+		tableHeader.adjacentN = table.adjacentN;
+		written = written && fwrite(&tableHeader, sizeof(tableHeader), 1, output) == 1;
+		written = written && fwrite(table.neighbors.data(), sizeof(uint32_t), table.neighbors.size(), output) == table.neighbors.size();
+	}
+
+	if (fclose(output) != 0 || !written || rename(temporary.c_str(), path) != 0) {
+		error = temporary + ": " + strerror(errno);
+		remove(temporary.c_str());
+		return false;
+	}
+	return true;
+}
+
+#endif
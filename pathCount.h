@@ -0,0 +1,161 @@
+/*
+ * File: pathCount.h
+ * -------------------------
+ * Counting of every placement of a word on the board: the
+ * number of distinct simple paths spelling it, rather than
+ * whether one exists. A depth-first search that does not stop
+ * at the first path is exponential on repetitive boards, so it
+ * is cut short with the number of walks spelling the rest of
+ * the word from each cell (paths that may revisit cells), which
+ * is counted for all cells at once by dynamic programming: a
+ * cell with no walk has no path either, and once the rest of
+ * the word only has letters found nowhere else in it, no walk
+ * can revisit a cell, so the walk count is the exact count.
+ * Words with no repeated letter are counted without any search.
+ * Counts saturate at UINT64_MAX.
+ */
+
+#ifndef PATH_COUNT_H
+#define PATH_COUNT_H
+
+/* Packages */
+#include <stdint.h>
+#include <string_view>
+#include <vector>
+
+#include "cellTable.h"
+
+/*
+ * Struct holding the scratch space of the path counts of one thread
+ * on one cell table, reused from word to word. The walk counts of a
+ * word take one row per letter, over the cells of its letter bucket,
+ * so their memory is bounded by the word length times the bucket size.
+ */
+struct pathCounter
+{
+	/* Data */
+	std::vector<uint32_t> bucketIndex; //position of every cell within its letter bucket
+	std::vector<uint64_t> walks; //per letter of the current word, walks spelling the rest from each cell of its bucket
+	std::vector<size_t> rowStart; //position of the row of every letter of the current word in walks
+	size_t exactFrom = 0; //first letter of the current word from which on no letter repeats elsewhere in it
+	visitedSet visited;
+
+	/* Functions */
+	uint64_t getWalks(const size_t charN, const uint32_t cell) const {
+		return walks[rowStart[charN] + bucketIndex[cell]];
+	}
+};
+
+/*
+ * Function name: addCounts(a, b)
+ * Returns the sum of two counts, saturating at UINT64_MAX
+ */
+const inline uint64_t addCounts(const uint64_t a, const uint64_t b) {
+	uint64_t sum;
+	return __builtin_add_overflow(a, b, &sum) ? UINT64_MAX : sum;
+}
+
+/*
+ * Function name: preparePathCounter(table, maxLength, counter)
+ * Sets up the scratch space of a given path counter for a cell table,
+ * with room for the walk counts of words of up to a given length, so
+ * that counting them allocates nothing
+ */
+template<size_t adjacentN>
+inline void preparePathCounter(const cellTable<adjacentN> &table, const size_t maxLength, pathCounter &counter) {
+	size_t maxBucket = 0;
+	counter.bucketIndex.assign(table.getCellCount(), 0);
+	for (size_t bucket = 0; bucket < ALPHABET; bucket++) {
+		maxBucket = std::max(maxBucket, table.getBucketSize(bucket));
+		for (size_t position = table.bucketStart[bucket]; position < table.bucketStart[bucket + 1]; position++) {
+			counter.bucketIndex[table.bucketCells[position]] = position - table.bucketStart[bucket];
+		}
+	}
+	counter.visited = visitedSet(table.getCellCount());
+	counter.rowStart.reserve(maxLength);
+	counter.walks.reserve(maxLength * maxBucket);
+}
+
+/*
+ * Function name: countWalks(table, word, counter)
+ * Fills the walk counts of a given word of capital letters in a given
+ * path counter, from the last letter back to the first: a cell holding
+ * the last letter has one walk, and a cell holding an earlier letter has
+ * the sum of the walks of its neighbors holding the next one.
+ */
+template<size_t adjacentN>
+inline void countWalks(const cellTable<adjacentN> &table, const std::string_view word, pathCounter &counter) {
+	size_t letterCounts[ALPHABET] = { 0 };
+	counter.rowStart.resize(word.length());
+	size_t size = 0;
+	for (size_t charN = 0; charN < word.length(); charN++) {
+		size_t bucket = getBucket(word[charN]);
+		letterCounts[bucket]++;
+		counter.rowStart[charN] = size;
+		size += table.getBucketSize(bucket);
+	}
+	counter.walks.resize(size);
+
+	counter.exactFrom = word.length();
+	while (counter.exactFrom > 0 && letterCounts[getBucket(word[counter.exactFrom - 1])] == 1) counter.exactFrom--;
+
+	size_t last = word.length() - 1;
+	std::fill(counter.walks.begin() + counter.rowStart[last], counter.walks.end(), 1);
+	for (size_t charN = last; charN-- > 0;) {
+		size_t bucket = getBucket(word[charN]);
+		uint64_t *row = &counter.walks[counter.rowStart[charN]];
+		for (size_t position = table.bucketStart[bucket]; position < table.bucketStart[bucket + 1]; position++) {
+			uint32_t cell = table.bucketCells[position];
+			uint64_t walks = 0;
+			for (uint64_t matches = table.getMatchingNeighbors(cell, word[charN + 1]); matches != 0; matches &= matches - 1) {
+				walks = addCounts(walks, counter.getWalks(charN + 1, table.getNeighbor(cell, getMatchSlot(matches))));
+			}
+			row[position - table.bucketStart[bucket]] = walks;
+		}
+	}
+}
+
+/*
+ * Function name: countPathsFrom(table, word, charN, cell, counter)
+ * Returns the number of simple paths spelling the letters of a word
+ * from charN on that start at a given cell (holding word[charN]) and
+ * avoid the cells visited so far, via depth-first search that stops
+ * at the cells with no walks and at the letter from which the walk
+ * counts are exact
+ * WARNING: the walk counts of the word must be filled first!
+ */
+template<size_t adjacentN>
+inline uint64_t countPathsFrom(const cellTable<adjacentN> &table, const std::string_view word, const size_t charN, const uint32_t cell, pathCounter &counter) {
+	uint64_t walks = counter.getWalks(charN, cell);
+	if (walks == 0 || charN + 1 >= counter.exactFrom) return walks; //dead-end or exact
+
+	counter.visited.set(cell);
+	uint64_t paths = 0;
+	for (uint64_t matches = table.getMatchingNeighbors(cell, word[charN + 1]); matches != 0; matches &= matches - 1) { //iterate over neighbors with the next letter
+		uint32_t neighbor = table.getNeighbor(cell, getMatchSlot(matches));
+		if (!counter.visited.test(neighbor)) paths = addCounts(paths, countPathsFrom(table, word, charN + 1, neighbor, counter)); //depth-first recursion
+	}
+
+	//reset and back-track
+	counter.visited.reset(cell);
+	return paths;
+}
+
+/*
+ * Function name: countPaths(table, word, begin, end, counter)
+ * Returns the number of simple paths spelling a given word of capital
+ * letters that start at the cells in positions [begin, end) of the
+ * bucket of its first letter
+ * WARNING: the walk counts of the word must be filled first!
+ */
+template<size_t adjacentN>
+inline uint64_t countPaths(const cellTable<adjacentN> &table, const std::string_view word, const size_t begin, const size_t end, pathCounter &counter) {
+	size_t bucketStart = table.bucketStart[getBucket(word[0])];
+	uint64_t paths = 0;
+	for (size_t position = begin; position < end; position++) {
+		paths = addCounts(paths, countPathsFrom(table, word, 0, table.bucketCells[bucketStart + position], counter));
+	}
+	return paths;
+}
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ * File: randomInput.h
+ * -------------------------
+ * Random letters and words for synthetic inputs, shared by
+ * generateInput and microBenchmark: letter distributions
+ * by name and words read off random paths of a board, so
+ * that they are found on it. The same generator state gives
+ * the same output.
+ */
+
+#ifndef RANDOM_INPUT_H
+#define RANDOM_INPUT_H
+
+/* Packages */
+#include <algorithm>
+#include <random>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "cellTable.h"
+
+/*
+ * Relative frequencies of the letters A to Z in English text,
+ * in hundredths of a percent.
+ */
+const double ENGLISH_FREQUENCIES[ALPHABET] = {
+	817, 149, 278, 425, 1270, 223, 202, 609, 697, 15, 77, 403, 241,
+	675, 751, 193, 10, 599, 633, 906, 276, 98, 236, 15, 197, 7
+};
+
+/*
+ * Function name: makeLetterDistribution(letters)
+ * Returns the distribution of letter buckets for a given name:
+ * uniform, english (English letter frequencies) or skewed
+ * (Zipf-like, each letter half as likely as the one before)
+ */
+inline std::discrete_distribution<size_t> makeLetterDistribution(const std::string &letters) {
+	std::vector<double> weights(ALPHABET, 1);
+	for (size_t bucket = 0; bucket < ALPHABET; bucket++) {
+		if (letters == "english") weights[bucket] = ENGLISH_FREQUENCIES[bucket];
+		else if (letters == "skewed") weights[bucket] = 1.0 / (1 << std::min<size_t>(bucket, 20));
+	}
+	return std::discrete_distribution<size_t>(weights.begin(), weights.end());
+}
+
+/*
+ * Function name: readPathWord(table, length, random, word)
+ * Sets a given string to the letters of a random simple path of
+ * a given length through the cell table.
+ * Returns false if the path ran into a dead end first.
+ */
+inline bool readPathWord(const cellTable<SIDES> &table, const size_t length, std::mt19937_64 &random, std::string &word) {
+	visitedSet visited(table.getCellCount());
+	uint32_t cell = std::uniform_int_distribution<uint32_t>(0, table.getCellCount() - 1)(random);
+
+	word.clear();
+	while (true) {
+		word.push_back(table.letters[cell]);
+		visited.set(cell);
+		if (word.length() == length) return true;
+
+		uint32_t choices[SIDES];
+		size_t choiceCount = 0;
+		for (size_t neighborN = 0; neighborN < SIDES; neighborN++) {
+			uint32_t neighbor = table.getNeighbor(cell, neighborN);
+			if (neighbor != NO_CELL && !visited.test(neighbor)) choices[choiceCount++] = neighbor;
+		}
+		if (choiceCount == 0) return false;
+
+		cell = choices[std::uniform_int_distribution<size_t>(0, choiceCount - 1)(random)];
+	}
+}
+
+#endif
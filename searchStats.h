@@ -0,0 +1,55 @@
+/*
+ * File: searchStats.h
+ * -------------------------
+ * Counters kept by the recursive search kernels when they
+ * are instantiated with countStats set, for --stats. The
+ * kernels default to not counting, in which case the counting
+ * code is compiled out and costs nothing.
+ */
+
+#ifndef SEARCH_STATS_H
+#define SEARCH_STATS_H
+
+/* Packages */
+#include <stddef.h>
+
+/*
+ * Struct holding the counters of the searches made by one thread.
+ */
+struct searchStats
+{
+	/* Data */
+	size_t starts = 0; //start cells tried
+	size_t calls = 0; //invocations of the recursive kernel that look past their cell
+	size_t visits = 0; //cells added to a path
+	size_t pruned = 0; //neighbors skipped as on the path or continuing no word, and dead-end calls
+	size_t depthSum = 0; //sum over the calls of the length of the path
+	size_t depth = 0; //length of the current path
+
+	/* Functions */
+	//counts a call of the kernel one cell deeper than its caller, to be matched by leave()
+	void enter() {
+		calls++;
+		depthSum += ++depth;
+	}
+
+	void leave() {
+		depth--;
+	}
+
+	//counts a call at a given path length, for kernels that keep their path on an explicit stack
+	void count(const size_t pathLength) {
+		calls++;
+		depthSum += pathLength;
+	}
+
+	void add(const searchStats &other) {
+		starts += other.starts;
+		calls += other.calls;
+		visits += other.visits;
+		pruned += other.pruned;
+		depthSum += other.depthSum;
+	}
+};
+
+#endif
@@ -0,0 +1,489 @@
+/*
+ * File: wordSearch.h
+ * -------------------------
+ * Depth-first search for a single dictionary word.
+ * For each word, iterate through the bucket of cells
+ * that have the first letter of the word and search
+ * through each cell's neighbors for the next letter.
+ * Both a recursive search and an iterative one, which keeps
+ * its path on an explicit stack provided by the caller, are
+ * available; they visit the cells in the same order. The
+ * iterative one also reports how much of a word it matched, so that
+ * the words after it sharing a dead prefix can be skipped.
+ * Small boards get kernels specialised at compile time that keep
+ * the visited set in machine words instead of a visitedSet.
+ * The recursive search can also count its work (see searchStats.h),
+ * and be anchored at the rarest letter of the word instead of its
+ * first, growing the path in both directions from there.
+ */
+
+#ifndef WORD_SEARCH_H
+#define WORD_SEARCH_H
+
+/* Packages */
+#include <algorithm>
+#include <stdint.h>
+#include <string_view>
+
+#include "cellTable.h"
+#include "searchStats.h"
+
+/*
+ * Function name: searchNodes(table, word, cell, visited, stats, path)
+ * Searches the neighbors of a given cell for the given remaining
+ * letters of a word via recursive depth-first search
+ * The word is a view into the caller's string, so no step of the
+ * search allocates.
+ * With countStats set, the search is counted in the given stats.
+ * With recordPath set, the ids of the cells holding the remaining
+ * letters on the path found are written to the given buffer.
+ */
+template<bool countStats = false, bool recordPath = false, size_t adjacentN>
+inline bool searchNodes(const cellTable<adjacentN> &table, const std::string_view word, const uint32_t cell, visitedSet &visited, searchStats *stats = NULL, uint32_t *path = NULL) {
+	if (word.length() == 0) return true; //found!
+	if (countStats) stats->enter();
+
+	uint64_t matches = table.getMatchingNeighbors(cell, word[0]);
+	if (matches == 0) { //dead-end
+		if (countStats) {
+			stats->pruned++;
+			stats->leave();
+		}
+		return false;
+	}
+	visited.set(cell);
+	if (countStats) stats->visits++;
+
+	bool found = false;
+	while (matches != 0) { //iterate over neighbors with the next letter
+		uint32_t neighbor = table.getNeighbor(cell, getMatchSlot(matches));
+		matches &= matches - 1;
+
+		if (visited.test(neighbor)) {
+			if (countStats) stats->pruned++;
+		} else if (searchNodes<countStats, recordPath>(table, word.substr(1), neighbor, visited, stats, recordPath ? path + 1 : path)) {
+			if (recordPath) path[0] = neighbor;
+			found = true; //depth-first recursion
+			break;
+		}
+	}
+
+	//reset and back-track
+	visited.reset(cell);
+	if (countStats) stats->leave();
+	return found;
+}
+
+/*
+ * Function name: passesLetterFilter(table, word)
+ * Returns whether a given word could be in the cell table judging by
+ * letters alone: the board must hold at least as many copies of each
+ * letter as the word, and every pair of consecutive letters of the
+ * word must appear next to each other somewhere on the board.
+ * Words that fail cannot be found, so their search can be skipped.
+ */
+template<size_t adjacentN>
+inline bool passesLetterFilter(const cellTable<adjacentN> &table, const std::string_view word) {
+	size_t letterCounts[ALPHABET] = { 0 };
+	size_t previous = ALPHABET;
+
+	for (size_t charN = 0; charN < word.length(); charN++) {
+		size_t bucket = getBucket(word[charN]);
+		if (bucket >= ALPHABET) return false; //not a capital letter
+		if (++letterCounts[bucket] > table.getBucketSize(bucket)) return false; //not enough copies
+		if (previous < ALPHABET && (table.adjacentLetters[previous] & (1u << bucket)) == 0) return false; //never adjacent
+
+		previous = bucket;
+	}
+
+	return true;
+}
+
+/*
+ * Function name: searchWord(table, word, visited, stats, path)
+ * Searches a cell table for a given word
+ * Iterates over all cells with the first letter and then searches
+ * over neighbors for subsequent letters
+ * With countStats set, the search is counted in the given stats.
+ * With recordPath set, the ids of the cells of the path found for the
+ * word are written to the given buffer of word.length() cells. This is
+ * its own instantiation, so the plain search pays nothing for it.
+ */
+template<bool countStats = false, bool recordPath = false, size_t adjacentN>
+inline bool searchWord(const cellTable<adjacentN> &table, const std::string_view word, visitedSet &visited, searchStats *stats = NULL, uint32_t *path = NULL) {
+	if (word.empty()) return false;
+	size_t bucket = getBucket(word[0]);
+	if (bucket >= ALPHABET) return false; //not a capital letter
+
+	for (size_t position = table.bucketStart[bucket]; position < table.bucketStart[bucket + 1]; position++) { //iterate through bucket
+		uint32_t cell = table.bucketCells[position];
+		if (countStats) stats->starts++;
+		if (searchNodes<countStats, recordPath>(table, word.substr(1), cell, visited, stats, recordPath ? path + 1 : path)) { //found
+			if (recordPath) path[0] = cell;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+ * Function name: searchNodesReverse(table, prefix, cell, visited, stats)
+ * Same as searchNodes(), but searches for the given preceding letters
+ * of a word from last to first, extending a path backwards
+ */
+template<bool countStats = false, size_t adjacentN>
+inline bool searchNodesReverse(const cellTable<adjacentN> &table, const std::string_view prefix, const uint32_t cell, visitedSet &visited, searchStats *stats = NULL) {
+	if (prefix.length() == 0) return true; //found!
+	if (countStats) stats->enter();
+
+	uint64_t matches = table.getMatchingNeighbors(cell, prefix.back());
+	if (matches == 0) { //dead-end
+		if (countStats) {
+			stats->pruned++;
+			stats->leave();
+		}
+		return false;
+	}
+	visited.set(cell);
+	if (countStats) stats->visits++;
+
+	bool found = false;
+	while (matches != 0) { //iterate over neighbors with the previous letter
+		uint32_t neighbor = table.getNeighbor(cell, getMatchSlot(matches));
+		matches &= matches - 1;
+
+		if (visited.test(neighbor)) {
+			if (countStats) stats->pruned++;
+		} else if (searchNodesReverse<countStats>(table, prefix.substr(0, prefix.length() - 1), neighbor, visited, stats)) {
+			found = true; //depth-first recursion
+			break;
+		}
+	}
+
+	//reset and back-track
+	visited.reset(cell);
+	if (countStats) stats->leave();
+	return found;
+}
+
+/*
+ * Function name: searchNodesAnchored(table, suffix, prefix, anchor, cell, visited, stats)
+ * Same as searchNodes() for the letters of a word after its anchor,
+ * but every path found for them is then extended backwards from the
+ * anchor cell for the letters before it (see searchNodesReverse()),
+ * keeping the forward path visited so the two halves cannot cross.
+ * The anchor must be on the path, so cell is never the anchor once
+ * the suffix is matched.
+ */
+template<bool countStats = false, size_t adjacentN>
+inline bool searchNodesAnchored(const cellTable<adjacentN> &table, const std::string_view suffix, const std::string_view prefix, const uint32_t anchor, const uint32_t cell, visitedSet &visited, searchStats *stats = NULL) {
+	if (suffix.length() == 0) { //forward half found, now the backward half
+		visited.set(cell);
+		bool found = searchNodesReverse<countStats>(table, prefix, anchor, visited, stats);
+		visited.reset(cell);
+		visited.set(anchor); //still on the forward path, but reset by searchNodesReverse()
+		return found;
+	}
+	if (countStats) stats->enter();
+
+	uint64_t matches = table.getMatchingNeighbors(cell, suffix[0]);
+	if (matches == 0) { //dead-end
+		if (countStats) {
+			stats->pruned++;
+			stats->leave();
+		}
+		return false;
+	}
+	visited.set(cell);
+	if (countStats) stats->visits++;
+
+	bool found = false;
+	while (matches != 0) { //iterate over neighbors with the next letter
+		uint32_t neighbor = table.getNeighbor(cell, getMatchSlot(matches));
+		matches &= matches - 1;
+
+		if (visited.test(neighbor)) {
+			if (countStats) stats->pruned++;
+		} else if (searchNodesAnchored<countStats>(table, suffix.substr(1), prefix, anchor, neighbor, visited, stats)) {
+			found = true; //depth-first recursion
+			break;
+		}
+	}
+
+	//reset and back-track
+	visited.reset(cell);
+	if (countStats) stats->leave();
+	return found;
+}
+
+/*
+ * Function name: searchWordAnchored(table, word, visited, stats)
+ * Same as searchWord(), but anchored at the letter of the word with
+ * the fewest cells on the board (the first of them on ties) rather
+ * than at its first letter: the search starts from every cell holding
+ * that letter and extends the path in both directions. On skewed
+ * boards this tries far fewer start cells, and a word with a letter
+ * missing from the board is rejected without trying any.
+ */
+template<bool countStats = false, size_t adjacentN>
+inline bool searchWordAnchored(const cellTable<adjacentN> &table, const std::string_view word, visitedSet &visited, searchStats *stats = NULL) {
+	if (word.empty()) return false;
+
+	size_t anchorN = 0;
+	size_t anchorSize = SIZE_MAX;
+	for (size_t charN = 0; charN < word.length(); charN++) {
+		size_t bucket = getBucket(word[charN]);
+		if (bucket >= ALPHABET) return false; //not a capital letter
+
+		size_t size = table.getBucketSize(bucket);
+		if (size < anchorSize) {
+			anchorN = charN;
+			anchorSize = size;
+		}
+	}
+
+	size_t bucket = getBucket(word[anchorN]);
+	std::string_view prefix = word.substr(0, anchorN);
+	std::string_view suffix = word.substr(anchorN + 1);
+	for (size_t position = table.bucketStart[bucket]; position < table.bucketStart[bucket + 1]; position++) { //iterate through bucket
+		uint32_t cell = table.bucketCells[position];
+		if (countStats) stats->starts++;
+
+		bool found = suffix.empty() ? searchNodesReverse<countStats>(table, prefix, cell, visited, stats)
+			: searchNodesAnchored<countStats>(table, suffix, prefix, cell, cell, visited, stats);
+		if (found) return true;
+	}
+
+	return false;
+}
+
+/*
+ * Struct defining the set of cells visited by a search on a small
+ * board as a fixed number of machine words. Unlike visitedSet it is
+ * passed around by value, so marking a cell touches no memory and
+ * back-tracking is free: the caller's copy is left unchanged.
+ */
+template<size_t wordsN>
+struct fixedVisitedSet
+{
+	/* Data */
+	uint64_t bits[wordsN] = { 0 };
+
+	/* Functions */
+	bool test(const uint32_t cell) const {
+		return (bits[cell >> 6] >> (cell & 63)) & 1;
+	}
+
+	void set(const uint32_t cell) {
+		bits[cell >> 6] |= (uint64_t)1 << (cell & 63);
+	}
+};
+
+/*
+ * Function name: searchNodesFixed(table, word, cell, visited, stats)
+ * Same as searchNodes() for boards of at most 64 * wordsN cells,
+ * with the visited set passed by value
+ */
+template<size_t wordsN, bool countStats = false, size_t adjacentN>
+inline bool searchNodesFixed(const cellTable<adjacentN> &table, const std::string_view word, const uint32_t cell, fixedVisitedSet<wordsN> visited, searchStats *stats = NULL) {
+	if (word.length() == 0) return true; //found!
+	if (countStats) stats->enter();
+
+	uint64_t matches = table.getMatchingNeighbors(cell, word[0]);
+	if (countStats) {
+		if (matches == 0) stats->pruned++; //dead-end
+		else stats->visits++;
+	}
+	visited.set(cell);
+
+	while (matches != 0) { //iterate over neighbors with the next letter
+		uint32_t neighbor = table.getNeighbor(cell, getMatchSlot(matches));
+		matches &= matches - 1;
+
+		if (visited.test(neighbor)) {
+			if (countStats) stats->pruned++;
+		} else if (searchNodesFixed<wordsN, countStats>(table, word.substr(1), neighbor, visited, stats)) { //depth-first recursion
+			if (countStats) stats->leave();
+			return true;
+		}
+	}
+
+	if (countStats) stats->leave();
+	return false; //back-track (the caller's visited set is untouched)
+}
+
+/*
+ * Function name: searchWordFixed(table, word, stats)
+ * Same as searchWord() for boards of at most 64 * wordsN cells
+ */
+template<size_t wordsN, bool countStats = false, size_t adjacentN>
+inline bool searchWordFixed(const cellTable<adjacentN> &table, const std::string_view word, searchStats *stats = NULL) {
+	if (word.empty()) return false;
+	size_t bucket = getBucket(word[0]);
+	if (bucket >= ALPHABET) return false; //not a capital letter
+
+	fixedVisitedSet<wordsN> visited;
+	for (size_t position = table.bucketStart[bucket]; position < table.bucketStart[bucket + 1]; position++) { //iterate through bucket
+		if (countStats) stats->starts++;
+		if (searchNodesFixed<wordsN, countStats>(table, word.substr(1), table.bucketCells[position], visited, stats)) return true; //found
+	}
+
+	return false;
+}
+
+/*
+ * Function name: searchWordBySize(table, word, visited, stats)
+ * Searches a cell table for a given word with the kernel specialised
+ * for its size: boards of up to 192 cells (8 layers) keep their visited
+ * set in one to three machine words, larger boards fall back to
+ * searchWord() and the given visited set
+ * With countStats set, the search is counted in the given stats.
+ */
+template<bool countStats = false, size_t adjacentN>
+inline bool searchWordBySize(const cellTable<adjacentN> &table, const std::string_view word, visitedSet &visited, searchStats *stats = NULL) {
+	switch ((table.getCellCount() + 63) / 64) {
+		case 0:
+		case 1: return searchWordFixed<1, countStats>(table, word, stats);
+		case 2: return searchWordFixed<2, countStats>(table, word, stats);
+		case 3: return searchWordFixed<3, countStats>(table, word, stats);
+		default: return searchWord<countStats>(table, word, visited, stats);
+	}
+}
+
+/*
+ * Struct defining a frame of the explicit stack of an iterative
+ * search: a cell on the current path and the mask of its neighbor
+ * slots holding the next letter that are left to try (in the
+ * format of getMatchingNeighbors()).
+ */
+struct searchFrame
+{
+	uint64_t candidates;
+	uint32_t cell;
+};
+
+/*
+ * Function name: searchWordIterative(table, word, visited, stack, matched, stats)
+ * Searches a cell table for a given word like searchWord(), but
+ * with an iterative depth-first search whose path is kept on a
+ * given preallocated stack of at least word.length() frames, so
+ * the call depth does not grow with the length of the word.
+ * If the word is not found, matched is set to the most letters of
+ * it that a path spelled.
+ * With countStats set, the search is counted in the given stats, each
+ * frame as the call of searchNodes() it stands for.
+ */
+template<bool countStats = false, size_t adjacentN>
+inline bool searchWordIterative(const cellTable<adjacentN> &table, const std::string_view word, visitedSet &visited, searchFrame *stack, size_t &matched, searchStats *stats = NULL) {
+	matched = 0;
+	if (word.empty()) return false;
+	size_t bucket = getBucket(word[0]);
+	if (bucket >= ALPHABET) return false; //not a capital letter
+
+	for (size_t position = table.bucketStart[bucket]; position < table.bucketStart[bucket + 1]; position++) { //iterate through bucket
+		uint32_t start = table.bucketCells[position];
+		if (countStats) stats->starts++;
+		if (word.length() == 1) return true; //found
+
+		size_t depth = 0; //index of the top frame, which matched word[depth]
+		stack[0] = { table.getMatchingNeighbors(start, word[1]), start };
+		visited.set(start);
+		matched = std::max<size_t>(matched, 1);
+		if (countStats) {
+			stats->count(1);
+			if (stack[0].candidates == 0) stats->pruned++; //dead-end
+			else stats->visits++;
+		}
+
+		while (true) {
+			searchFrame &frame = stack[depth];
+
+			//advance to the next unvisited neighbor with the next letter
+			uint32_t neighbor = NO_CELL;
+			while (frame.candidates != 0) {
+				uint32_t candidate = table.getNeighbor(frame.cell, getMatchSlot(frame.candidates));
+				frame.candidates &= frame.candidates - 1;
+				if (!visited.test(candidate)) {
+					neighbor = candidate;
+					break;
+				}
+				if (countStats) stats->pruned++;
+			}
+
+			if (neighbor == NO_CELL) { //reset and back-track
+				visited.reset(frame.cell);
+				if (depth == 0) break;
+				depth--;
+				continue;
+			}
+
+			if (depth + 2 == word.length()) { //found, reset the path
+				for (size_t frameN = 0; frameN <= depth; frameN++) {
+					visited.reset(stack[frameN].cell);
+				}
+				return true;
+			}
+			matched = std::max(matched, depth + 2);
+
+			uint64_t candidates = table.getMatchingNeighbors(neighbor, word[depth + 2]);
+			if (countStats) stats->count(depth + 2);
+			if (candidates == 0) { //dead-end, no need to descend
+				if (countStats) stats->pruned++;
+				continue;
+			}
+
+			stack[++depth] = { candidates, neighbor }; //descend
+			visited.set(neighbor);
+			if (countStats) stats->visits++;
+		}
+	}
+
+	return false;
+}
+
+template<bool countStats = false, size_t adjacentN>
+inline bool searchWordIterative(const cellTable<adjacentN> &table, const std::string_view word, visitedSet &visited, searchFrame *stack, searchStats *stats = NULL) {
+	size_t matched;
+	return searchWordIterative<countStats>(table, word, visited, stack, matched, stats);
+}
+
+/*
+ * Struct remembering the longest prefix of the last word not found
+ * by searchWordMemo() that some path of the board spells. No path
+ * spells that prefix plus its next letter, so neither can a path
+ * spell any later word starting with them.
+ */
+struct searchMemo
+{
+	std::string_view word; //last word not found
+	size_t matched = 0; //letters of its longest prefix on the board
+};
+
+/*
+ * Function name: searchWordMemo(table, word, visited, stack, memo, stats)
+ * Same as searchWordIterative() for words searched one after the other,
+ * such as those of a sorted dictionary, in which consecutive words
+ * share long prefixes: words with a prefix that a previous search found
+ * no path for (see searchMemo) are rejected without a search.
+ * With countStats set, the searches are counted in the given stats, and
+ * every word rejected without one as pruned.
+ */
+template<bool countStats = false, size_t adjacentN>
+inline bool searchWordMemo(const cellTable<adjacentN> &table, const std::string_view word, visitedSet &visited, searchFrame *stack, searchMemo &memo, searchStats *stats = NULL) {
+	size_t common = 0;
+	while (common < word.length() && common < memo.word.length() && word[common] == memo.word[common]) common++;
+	if (!memo.word.empty() && common > memo.matched) { //dead prefix
+		if (countStats) stats->pruned++;
+		return false;
+	}
+
+	size_t matched;
+	if (searchWordIterative<countStats>(table, word, visited, stack, matched, stats)) return true;
+
+	memo.word = word;
+	memo.matched = matched;
+	return false;
+}
+
+#endif
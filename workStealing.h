@@ -0,0 +1,317 @@
+/*
+ * File: workStealing.h
+ * -------------------------
+ * Work-stealing scheduler for the trie-guided search on
+ * several threads. The cost of the search from a cell depends
+ * on how many dictionary prefixes its neighborhood spells, so
+ * a fixed share of the cells per thread leaves threads idle
+ * while one finishes a costly region. Instead, every thread
+ * keeps a deque of tasks, seeded with its share of the start
+ * cells as a single range. A thread runs tasks from the back of
+ * its own deque and, once it has none, steals from the front of
+ * the others, where the largest tasks are. While a thread is
+ * out of work, the ones still searching split their tasks for
+ * it: the back half of the cells left in their range, or the
+ * first levels of the subtree they are in, as the searches of
+ * the subtrees below short paths. Tasks are only made when a
+ * thread is idle, so a balanced search costs next to nothing.
+ * A thread only splits while its own deque is empty, so the deques
+ * are fixed-capacity rings allocated with the scheduler, and a
+ * search allocates nothing.
+ */
+
+#ifndef WORK_STEALING_H
+#define WORK_STEALING_H
+
+/* Packages */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+#include "cellTable.h"
+#include "dictionaryTrie.h"
+#include "searchStats.h"
+
+/* Macros */
+#define STEAL_DEPTH 3 //longest path a task can start below
+
+/*
+ * Struct defining a task: the searches from a range of start cells,
+ * or the search of the subtree below a path of cells whose letters
+ * lead to a given trie node.
+ */
+struct trieTask
+{
+	uint32_t length; //cells on the path, 0 for a range of start cells
+	uint32_t begin, end; //range: ids of the start cells
+	uint32_t nodeIndex; //path: trie node of its letters
+	uint32_t path[STEAL_DEPTH]; //path: its cells, the task searching from the last
+};
+
+/*
+ * Struct holding the deque of tasks of one thread, taken from the
+ * back by its thread and from the front by the others, as a ring of
+ * fixed capacity.
+ */
+struct taskDeque
+{
+	/* Data */
+	std::mutex mutex;
+	std::vector<trieTask> ring;
+	size_t front = 0; //slot of the first task
+	std::atomic<size_t> count{0}; //tasks in the ring, readable without the lock
+
+	/* Functions */
+	//empties the deque and makes room for a given number of tasks
+	void reset(const size_t capacity) {
+		std::lock_guard<std::mutex> lock(mutex);
+		ring.resize(std::max<size_t>(capacity, 1));
+		front = 0;
+		count = 0;
+	}
+
+	//appends a task, returns false (dropping it) if the deque is full
+	bool push(const trieTask &task) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (count == ring.size()) return false;
+		ring[(front + count) % ring.size()] = task;
+		count++;
+		return true;
+	}
+
+	bool popBack(trieTask &task) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (count == 0) return false;
+		task = ring[(front + count - 1) % ring.size()];
+		count--;
+		return true;
+	}
+
+	bool popFront(trieTask &task) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (count == 0) return false;
+		task = ring[front];
+		front = (front + 1) % ring.size();
+		count--;
+		return true;
+	}
+};
+
+/*
+ * Struct holding how busy one thread was with the tasks of a
+ * work-stealing search, kept with --stats.
+ */
+struct workerLoad
+{
+	double busyTime = 0; //milliseconds running tasks
+	size_t tasks = 0; //tasks run
+	size_t steals = 0; //tasks taken from other threads
+};
+
+/*
+ * Struct holding the task deques of the threads of a work-stealing
+ * search. The search is over once no task is pending, counting those
+ * running, which may still split off more. A thread only pushes onto
+ * its own deque, and only while it is empty (see wantsSplit()), so
+ * once its seeds are taken a deque never holds more than one task: a
+ * capacity of the seeds per thread is enough. A scheduler can be reset
+ * for the next search, reusing its deques.
+ */
+struct stealingScheduler
+{
+	/* Data */
+	std::vector<taskDeque> deques;
+	std::atomic<size_t> pending{0}; //tasks pushed and not yet finished
+	std::atomic<size_t> waiting{0}; //threads out of tasks
+	std::mutex idleMutex;
+	std::condition_variable idle; //woken when there may be a task to steal or the search is over
+
+	/* Functions */
+	stealingScheduler() {}
+
+	stealingScheduler(const size_t threadCount, const size_t capacity) {
+		reset(threadCount, capacity);
+	}
+
+	//empties the scheduler for a search on a given number of threads, seeded with up to capacity tasks each
+	void reset(const size_t threadCount, const size_t capacity) {
+		if (deques.size() != threadCount) std::vector<taskDeque>(threadCount).swap(deques);
+		for (taskDeque &deque : deques) deque.reset(capacity);
+		pending = 0;
+		waiting = 0;
+	}
+
+	//returns whether a given thread should split its task, as another is out of work and it has none left to steal
+	bool wantsSplit(const size_t threadN) const {
+		return waiting > 0 && deques[threadN].count == 0;
+	}
+
+	//pushes a task onto the deque of a given thread, returns false (dropping it) if the deque is full
+	bool push(const size_t threadN, const trieTask &task) {
+		pending++;
+		if (!deques[threadN].push(task)) {
+			pending--;
+			return false;
+		}
+		if (waiting > 0) idle.notify_one();
+		return true;
+	}
+
+	//takes the next task of a thread, stealing one if it has none, returns false once the search is over
+	bool take(const size_t threadN, trieTask &task, workerLoad &load) {
+		if (deques[threadN].popBack(task)) return true;
+
+		waiting++;
+		while (pending > 0) {
+			for (size_t offset = 1; offset < deques.size(); offset++) {
+				if (deques[(threadN + offset) % deques.size()].popFront(task)) {
+					waiting--;
+					load.steals++;
+					return true;
+				}
+			}
+
+			//sleep rather than spin, so as not to slow the threads searching on a busy machine
+			std::unique_lock<std::mutex> lock(idleMutex);
+			if (pending > 0) idle.wait_for(lock, std::chrono::microseconds(100)); //bounds a missed wake-up
+		}
+		waiting--;
+		return false;
+	}
+
+	void finish() {
+		if (--pending == 0) idle.notify_all();
+	}
+};
+
+/*
+ * Function name: searchTrieSplit(table, trie, scheduler, threadN, task, visited, foundFlags, stats)
+ * Same as searchTrie() from the last cell of the path of a given task,
+ * but while another thread is out of work (see wantsSplit()), the
+ * children of the paths shorter than STEAL_DEPTH are pushed as tasks
+ * onto the deque of the given thread instead of being searched. The path of the task is
+ * extended and restored in place.
+ */
+template<bool countStats, size_t adjacentN>
+inline void searchTrieSplit(const cellTable<adjacentN> &table, const dictionaryTrie &trie, stealingScheduler &scheduler, const size_t threadN, trieTask &task, visitedSet &visited, std::vector<bool> &foundFlags, searchStats *stats) {
+	uint32_t nodeIndex = task.nodeIndex;
+	uint32_t cell = task.path[task.length - 1];
+	if (task.length == STEAL_DEPTH) {
+		searchTrie<countStats>(table, trie, nodeIndex, cell, visited, foundFlags, stats);
+		return;
+	}
+
+	const dictionaryTrie::trieNode &node = trie.nodes[nodeIndex];
+	if (node.wordIndex >= 0) foundFlags[node.wordIndex] = true; //found!
+	if (node.childMask == 0) return; //no longer prefix in dictionary
+
+	visited.set(cell);
+	if (countStats) {
+		stats->enter();
+		stats->visits++;
+	}
+
+	for (size_t neighborN = 0; neighborN < adjacentN; neighborN++) { //iterate over neighbors
+		uint32_t neighbor = table.getNeighbor(cell, neighborN);
+		if (neighbor == NO_CELL) continue;
+
+		uint32_t child = visited.test(neighbor) ? 0 : trie.getChild(nodeIndex, table.letters[neighbor]);
+		if (child == 0) {
+			if (countStats) stats->pruned++;
+			continue;
+		}
+
+		task.path[task.length++] = neighbor;
+		task.nodeIndex = child;
+		if (!scheduler.wantsSplit(threadN) || !scheduler.push(threadN, task)) searchTrieSplit<countStats>(table, trie, scheduler, threadN, task, visited, foundFlags, stats); //depth-first recursion, unless split off for the idle thread
+		task.length--;
+	}
+	task.nodeIndex = nodeIndex;
+
+	//reset and back-track
+	visited.reset(cell);
+	if (countStats) stats->leave();
+}
+
+/*
+ * Function name: searchRangeSplit(table, trie, scheduler, threadN, task, visited, foundFlags, stats)
+ * Starts a search (see searchTrieSplit()) from every cell of the range
+ * of a given task. While another thread is out of work (see
+ * wantsSplit()), the back half of the cells left is pushed as a task
+ * onto the deque of the given thread, so that ranges are split as
+ * needed rather than up front.
+ */
+template<bool countStats, size_t adjacentN>
+inline void searchRangeSplit(const cellTable<adjacentN> &table, const dictionaryTrie &trie, stealingScheduler &scheduler, const size_t threadN, trieTask &task, visitedSet &visited, std::vector<bool> &foundFlags, searchStats *stats) {
+	uint32_t end = task.end;
+	for (uint32_t cell = task.begin; cell < end; cell++) {
+		if (end - cell > 1 && scheduler.wantsSplit(threadN)) { //split off for the idle thread
+			trieTask half = task;
+			half.begin = cell + (end - cell) / 2;
+			half.end = end;
+			if (scheduler.push(threadN, half)) end = half.begin;
+		}
+
+		uint32_t child = trie.getChild(0, table.letters[cell]);
+		if (child == 0) continue;
+
+		if (countStats) stats->starts++;
+		trieTask start;
+		start.length = 1;
+		start.nodeIndex = child;
+		start.path[0] = cell;
+		searchTrieSplit<countStats>(table, trie, scheduler, threadN, start, visited, foundFlags, stats);
+	}
+}
+
+/*
+ * Function name: seedRange(scheduler, begin, end, threadN)
+ * Pushes a task searching from the cells with an id in [begin, end)
+ * onto the deque of a given thread, which must have room for it
+ */
+inline void seedRange(stealingScheduler &scheduler, const uint32_t begin, const uint32_t end, const size_t threadN) {
+	trieTask task;
+	task.length = 0;
+	task.begin = begin;
+	task.end = end;
+	scheduler.push(threadN, task);
+}
+
+/*
+ * Function name: searchCellsStealing(table, trie, scheduler, threadN, visited, foundFlags, load, stats)
+ * Runs the tasks of a work-stealing trie-guided search as the given
+ * thread until the search is over. With countStats set, the search is
+ * counted in the given stats and the time spent running tasks in the
+ * given load.
+ */
+template<bool countStats = false, size_t adjacentN>
+inline void searchCellsStealing(const cellTable<adjacentN> &table, const dictionaryTrie &trie, stealingScheduler &scheduler, const size_t threadN, visitedSet &visited, std::vector<bool> &foundFlags, workerLoad &load, searchStats *stats = NULL) {
+	trieTask task;
+	while (scheduler.take(threadN, task, load)) {
+		std::chrono::steady_clock::time_point start;
+		if (countStats) start = std::chrono::steady_clock::now();
+
+		if (task.length == 0) {
+			searchRangeSplit<countStats>(table, trie, scheduler, threadN, task, visited, foundFlags, stats);
+		} else {
+			//the cells above the subtree are on its path
+			if (countStats) stats->depth = task.length - 1;
+			for (size_t charN = 0; charN + 1 < task.length; charN++) visited.set(task.path[charN]);
+			searchTrieSplit<countStats>(table, trie, scheduler, threadN, task, visited, foundFlags, stats);
+			for (size_t charN = 0; charN + 1 < task.length; charN++) visited.reset(task.path[charN]);
+			if (countStats) stats->depth = 0;
+		}
+
+		if (countStats) {
+			load.busyTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			load.tasks++;
+		}
+		scheduler.finish();
+	}
+}
+
+#endif